@@ -10,6 +10,7 @@
 #include "Utilities/JIT.h"
 #include <thread>
 #include <cfenv>
+#include <map>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -2747,8 +2748,113 @@ void thread_ctrl::detect_cpu_layout()
 	}
 }
 
+// Splits the largest cache domain of the fastest cores between RSX, PPU and SPU threads
+static u64 get_topology_affinity_mask(thread_class group, u64 allowed_mask)
+{
+	struct layout_t
+	{
+		u64 rsx;
+		u64 rsx_aux;
+		u64 ppu;
+		u64 spu;
+		u64 all;
+	};
+
+	static const layout_t layout = [&]()
+	{
+		const auto& cores = utils::get_cpu_topology();
+
+		u32 best_efficiency = 0;
+
+		for (const auto& core : cores)
+		{
+			if (core.threads & allowed_mask)
+			{
+				best_efficiency = std::max(best_efficiency, core.efficiency);
+			}
+		}
+
+		// Cache domain -> usable cores, efficiency cores of hybrid CPUs are left to general threads
+		std::map<u32, std::vector<u64>> domains;
+
+		for (const auto& core : cores)
+		{
+			if ((core.threads & allowed_mask) == core.threads && core.efficiency == best_efficiency)
+			{
+				domains[core.cache_domain].push_back(core.threads);
+			}
+		}
+
+		const std::vector<u64>* main_domain = nullptr;
+
+		for (const auto& [id, domain] : domains)
+		{
+			// Ties go to the lowest domain which is usually on the first NUMA node
+			if (!main_domain || domain.size() > main_domain->size())
+			{
+				main_domain = &domain;
+			}
+		}
+
+		layout_t result{allowed_mask, allowed_mask, allowed_mask, allowed_mask, allowed_mask};
+
+		if (!main_domain || main_domain->size() < 6)
+		{
+			sig_log.notice("Topology scheduler: the largest cache domain has %u usable cores, leaving placement to the OS", main_domain ? main_domain->size() : 0);
+			return result;
+		}
+
+		// RSX takes a core of its own, PPU threads share two (three on wide domains), SPUs get the remainder.
+		// RSX helper threads get another core on domains of 8 cores or more, otherwise they run alongside SPUs.
+		// Each class owns whole cores so busy SPUs never run on SMT siblings of the RSX or PPU threads.
+		const auto& domain = *main_domain;
+		const usz ppu_cores = domain.size() >= 12 ? 3 : 2;
+		const usz aux_cores = domain.size() >= 8 ? 1 : 0;
+		const usz spu_cores = domain.size() - 1 - aux_cores - ppu_cores;
+
+		result.rsx = domain.back();
+		result.rsx_aux = 0;
+		result.ppu = 0;
+		result.spu = 0;
+
+		for (usz i = 0; i < domain.size() - 1; i++)
+		{
+			(i < spu_cores ? result.spu : i < spu_cores + ppu_cores ? result.ppu : result.rsx_aux) |= domain[i];
+		}
+
+		if (!aux_cores)
+		{
+			result.rsx_aux = result.spu;
+		}
+
+		sig_log.notice("Topology scheduler: %u cores in %u cache domains, using %u cores (RSX: 0x%llx, RSX helpers: 0x%llx, PPU: 0x%llx, SPU: 0x%llx)",
+			cores.size(), domains.size(), domain.size(), result.rsx, result.rsx_aux, result.ppu, result.spu);
+
+		for (const auto& core : cores)
+		{
+			sig_log.notice("Topology scheduler: core 0x%llx, cache domain %u, NUMA node %u, efficiency %u", core.threads, core.cache_domain, core.numa_node, core.efficiency);
+		}
+
+		return result;
+	}();
+
+	switch (group)
+	{
+	case thread_class::rsx: return layout.rsx;
+	case thread_class::rsx_aux: return layout.rsx_aux;
+	case thread_class::ppu: return layout.ppu;
+	case thread_class::spu: return layout.spu;
+	default: return layout.all;
+	}
+}
+
 u64 thread_ctrl::get_affinity_mask(thread_class group)
 {
+	if (g_cfg.core.thread_scheduler == thread_scheduler_mode::topology)
+	{
+		return get_topology_affinity_mask(group, process_affinity_mask);
+	}
+
 	detect_cpu_layout();
 
 	if (const auto thread_count = utils::get_thread_count())
@@ -2937,6 +3043,7 @@ u64 thread_ctrl::get_affinity_mask(thread_class group)
 			case thread_class::general:
 				return all_cores_mask;
 			case thread_class::rsx:
+			case thread_class::rsx_aux:
 				return rsx_mask;
 			case thread_class::ppu:
 				return ppu_mask;
@@ -24,7 +24,8 @@ enum class thread_class : u32
 	general,
 	rsx,
 	spu,
-	ppu
+	ppu,
+	rsx_aux // RSX helper threads (FIFO decoder, DMA offload)
 };
 
 enum class thread_state : u32
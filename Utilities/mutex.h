@@ -178,10 +178,202 @@ public:
 	}
 };
 
+// Shared mutex split into cache line sized shards, readers only touch the shard assigned to their thread.
+// Writers lock every shard, so it is only worth it for data which is read by many threads and rarely modified.
+class sharded_shared_mutex final
+{
+	static constexpr u32 c_shards = 16;
+
+	struct alignas(64) shard_t
+	{
+		shared_mutex mutex;
+	};
+
+	shard_t m_shards[c_shards]{};
+
+	static u32 get_shard() noexcept
+	{
+		static atomic_t<u32> s_next_shard = 0;
+		thread_local const u32 s_shard = s_next_shard++ % c_shards;
+		return s_shard;
+	}
+
+	shared_mutex& own() noexcept
+	{
+		return m_shards[get_shard()].mutex;
+	}
+
+	const shared_mutex& own() const noexcept
+	{
+		return m_shards[get_shard()].mutex;
+	}
+
+	// Lock all shards except the current thread's one (without blocking)
+	bool try_lock_others()
+	{
+		const u32 skip = get_shard();
+
+		for (u32 i = 0; i < c_shards; i++)
+		{
+			if (i != skip && !m_shards[i].mutex.try_lock())
+			{
+				while (i--)
+				{
+					if (i != skip)
+					{
+						m_shards[i].mutex.unlock();
+					}
+				}
+
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+public:
+	constexpr sharded_shared_mutex() = default;
+
+	bool try_lock_shared()
+	{
+		return own().try_lock_shared();
+	}
+
+	void lock_shared()
+	{
+		own().lock_shared();
+	}
+
+	void unlock_shared()
+	{
+		own().unlock_shared();
+	}
+
+	bool try_lock()
+	{
+		for (u32 i = 0; i < c_shards; i++)
+		{
+			if (!m_shards[i].mutex.try_lock())
+			{
+				while (i--)
+				{
+					m_shards[i].mutex.unlock();
+				}
+
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	void lock()
+	{
+		// Fixed order, so concurrent writers cannot deadlock
+		for (auto& shard : m_shards)
+		{
+			shard.mutex.lock();
+		}
+	}
+
+	void unlock()
+	{
+		for (u32 i = c_shards; i--;)
+		{
+			m_shards[i].mutex.unlock();
+		}
+	}
+
+	// There is no blocking lock_upgrade: waiting for the other shards while holding our own would deadlock with writers
+	bool try_lock_upgrade()
+	{
+		if (!own().try_lock_upgrade())
+		{
+			return false;
+		}
+
+		if (!try_lock_others())
+		{
+			own().lock_downgrade();
+			return false;
+		}
+
+		return true;
+	}
+
+	void lock_downgrade()
+	{
+		const u32 skip = get_shard();
+
+		for (u32 i = c_shards; i--;)
+		{
+			if (i != skip)
+			{
+				m_shards[i].mutex.unlock();
+			}
+		}
+
+		own().lock_downgrade();
+	}
+
+	// Optimized wait for lockability without locking, relaxed
+	void lock_unlock()
+	{
+		for (auto& shard : m_shards)
+		{
+			shard.mutex.lock_unlock();
+		}
+	}
+
+	// Check whether can immediately obtain an exclusive (writer) lock
+	bool is_free() const
+	{
+		for (auto& shard : m_shards)
+		{
+			if (!shard.mutex.is_free())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// Check whether can immediately obtain a shared (reader) lock
+	// All shards are checked so that a writer still acquiring them is visible to any thread
+	bool is_lockable() const
+	{
+		for (auto& shard : m_shards)
+		{
+			if (!shard.mutex.is_lockable())
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool has_waiters() const
+	{
+		for (auto& shard : m_shards)
+		{
+			if (shard.mutex.has_waiters())
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+};
+
 // Simplified shared (reader) lock implementation.
+template <typename Mutex = shared_mutex>
 class reader_lock final
 {
-	shared_mutex& m_mutex;
+	Mutex& m_mutex;
 	bool m_upgraded = false;
 
 public:
@@ -189,7 +381,7 @@ public:
 
 	reader_lock& operator=(const reader_lock&) = delete;
 
-	explicit reader_lock(shared_mutex& mutex)
+	explicit reader_lock(Mutex& mutex)
 		: m_mutex(mutex)
 	{
 		m_mutex.lock_shared();
@@ -14,9 +14,11 @@
 #include "Emu/perf_meter.hpp"
 
 #include "util/asm.hpp"
+#include "util/sysinfo.hpp"
 #include <thread>
 #include <unordered_map>
 #include <map>
+#include <deque>
 
 #if defined(ARCH_X64)
 #include <emmintrin.h>
@@ -1256,6 +1258,8 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 		// Monitor the performance only of the actual suspend processing owner
 		perf_meter<"SUSPEND"_u64> perf0;
 
+		const u64 start_tsc = utils::get_tsc();
+
 		// First thread to push the work to the workload list pauses all threads and processes it
 		std::lock_guard lock(s_cpu_lock);
 
@@ -1314,6 +1318,8 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 		// Second increment: all threads paused
 		g_suspend_counter++;
 
+		const u64 paused_tsc = utils::get_tsc();
+
 		// Extract queue and reverse element order (FILO to FIFO) (TODO: maybe leave order as is?)
 		auto* head = s_pushed.exchange(nullptr);
 
@@ -1338,6 +1344,8 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 			while (prev);
 		}
 
+		u32 work_count = 0;
+
 		// Execute prefetch hint(s)
 		for (auto work = head; work; work = work->next)
 		{
@@ -1345,6 +1353,8 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 			{
 				utils::prefetch_write(work->prf_list[0]);
 			}
+
+			work_count++;
 		}
 
 		cpu_counter::for_all_cpu(copy2, [&](cpu_thread* cpu)
@@ -1363,6 +1373,11 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 				if (work->prio == prio)
 				{
 					work->exec(work->func_ptr, work->res_buf);
+
+					if (work->stat)
+					{
+						work->stat->works++;
+					}
 				}
 			}
 		}
@@ -1375,6 +1390,11 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 			cpu->state -= cpu_flag::pause;
 			return true;
 		});
+
+		if (stat)
+		{
+			stat->record(start_tsc, paused_tsc, utils::get_tsc(), utils::popcnt128(copy2), work_count - 1);
+		}
 	}
 	else
 	{
@@ -1390,6 +1410,135 @@ bool cpu_thread::suspend_work::push(cpu_thread* _this) noexcept
 	return true;
 }
 
+// Call sites which have used suspend_all() (never removed, so pointers stay valid)
+static shared_mutex s_suspend_stats_mutex;
+static std::deque<cpu_thread::suspend_stat> s_suspend_stats;
+
+static std::string_view get_file_name(const char* path)
+{
+	const std::string_view result = path;
+	return result.substr(result.find_last_of("/\\") + 1);
+}
+
+cpu_thread::suspend_stat* cpu_thread::get_suspend_stat(const char* file, const char* func, u32 line) noexcept
+{
+	const auto find = [&]() -> suspend_stat*
+	{
+		for (suspend_stat& stat : s_suspend_stats)
+		{
+			if (stat.line == line && std::strcmp(stat.file, file) == 0)
+			{
+				return &stat;
+			}
+		}
+
+		return nullptr;
+	};
+
+	{
+		reader_lock lock(s_suspend_stats_mutex);
+
+		if (auto stat = find())
+		{
+			return stat;
+		}
+	}
+
+	std::lock_guard lock(s_suspend_stats_mutex);
+
+	if (auto stat = find())
+	{
+		return stat;
+	}
+
+	suspend_stat& stat = s_suspend_stats.emplace_back();
+	stat.file = file;
+	stat.func = func;
+	stat.line = line;
+	return &stat;
+}
+
+void cpu_thread::suspend_stat::record(u64 start_tsc, u64 paused_tsc, u64 end_tsc, u32 paused_threads, u32 batched_works) noexcept
+{
+	const ullong freq = utils::get_tsc_freq();
+
+	if (!freq)
+	{
+		return;
+	}
+
+	const u64 pause = static_cast<u64>((paused_tsc - start_tsc) * 1000'000'000. / freq);
+	const u64 hold = static_cast<u64>((end_tsc - paused_tsc) * 1000'000'000. / freq);
+
+	count++;
+	threads += paused_threads;
+	pause_ns += pause;
+	hold_ns += hold;
+	batched += batched_works;
+	max_ns.fetch_op([&](u64& val)
+	{
+		if (val < pause + hold)
+		{
+			val = pause + hold;
+			return true;
+		}
+
+		return false;
+	});
+
+	if (const u64 budget = g_cfg.core.suspend_all_budget; budget && pause + hold >= budget * 1000)
+	{
+		perf_log.warning(u8"suspend_all() from %s (%s:%u) exceeded the budget: %.3fµs (%u threads paused in %.3fµs, held for %.3fµs)", func, get_file_name(file), line, (pause + hold) / 1000., paused_threads, pause / 1000., hold / 1000.);
+	}
+}
+
+void cpu_thread::report_suspend_stats() noexcept
+{
+	struct site_snapshot
+	{
+		suspend_stat* stat;
+		u64 works, count, threads, pause, hold, max, batched;
+	};
+
+	std::vector<site_snapshot> sites;
+
+	{
+		reader_lock lock(s_suspend_stats_mutex);
+
+		for (suspend_stat& stat : s_suspend_stats)
+		{
+			// Take the counters once, so that concurrent suspensions cannot change them while sorting
+			site_snapshot site{&stat, stat.works.exchange(0), stat.count.exchange(0), stat.threads.exchange(0), stat.pause_ns.exchange(0), stat.hold_ns.exchange(0), stat.max_ns.exchange(0), stat.batched.exchange(0)};
+
+			if (site.works || site.count)
+			{
+				sites.push_back(site);
+			}
+		}
+	}
+
+	std::sort(sites.begin(), sites.end(), [](const site_snapshot& a, const site_snapshot& b)
+	{
+		return a.pause + a.hold > b.pause + b.hold;
+	});
+
+	for (const site_snapshot& site : sites)
+	{
+		const suspend_stat* stat = site.stat;
+
+		if (!site.count)
+		{
+			perf_log.notice("Suspend stats for %s (%s:%u): %u workloads, all executed in suspensions of other call sites", stat->func, get_file_name(stat->file), stat->line, site.works);
+			continue;
+		}
+
+		// Times belong to the suspensions this call site performed, workloads include those batched into other suspensions
+		perf_log.notice(u8"Suspend stats for %s (%s:%u): %u workloads, %u suspensions (total %.3fms), avg %.1f threads paused in %.3fµs, held for %.3fµs, max %.3fµs, %u workloads of other call sites batched",
+			stat->func, get_file_name(stat->file), stat->line, site.works, site.count, (site.pause + site.hold) / 1000'000., site.threads * 1. / site.count, site.pause / 1000. / site.count, site.hold / 1000. / site.count,
+			site.max / 1000., site.batched);
+	}
+}
+
 void cpu_thread::cleanup() noexcept
 {
 	if (u64 count = s_cpu_counter)
@@ -69,6 +69,9 @@ public:
 	// Public thread state
 	atomic_bs_t<cpu_flag> state{cpu_flag::stop + cpu_flag::wait};
 
+	// Position in the lv2 scheduler timeout queue (protected by lv2_obj::g_mutex)
+	u32 timeout_slot = umax;
+
 	// Process thread state, return true if the checker must return
 	bool check_state() noexcept;
 
@@ -192,6 +195,27 @@ public:
 	virtual void cpu_on_stop() {}
 
 	// For internal use
+	// Cost of suspend_all() for one call site, reported with the performance report
+	struct suspend_stat
+	{
+		const char* file;
+		const char* func;
+		u32 line;
+
+		atomic_t<u64> works{};    // Workloads of this call site executed, including those batched into other suspensions
+		atomic_t<u64> count{};    // Suspensions performed for this call site
+		atomic_t<u64> threads{};  // Sum of paused threads
+		atomic_t<u64> pause_ns{}; // Sum of time until all threads were paused
+		atomic_t<u64> hold_ns{};  // Sum of time the threads were held paused
+		atomic_t<u64> max_ns{};   // Longest suspension
+		atomic_t<u64> batched{};  // Workloads of other callers executed in the same suspension
+
+		void record(u64 start_tsc, u64 paused_tsc, u64 end_tsc, u32 paused_threads, u32 batched_works) noexcept;
+	};
+
+	// Find or register the statistics of a call site
+	static suspend_stat* get_suspend_stat(const char* file, const char* func, u32 line) noexcept;
+
 	struct suspend_work
 	{
 		// Task priority
@@ -212,16 +236,33 @@ public:
 		// Next object in the linked list
 		suspend_work* next;
 
+		// Statistics of the call site (set by suspend_all)
+		suspend_stat* stat;
+
 		// Internal method
 		bool push(cpu_thread* _this) noexcept;
 	};
 
 	// Suspend all threads and execute op (may be executed by other thread than caller!)
 	template <u8 Prio = 0, typename F>
-	static auto suspend_all(cpu_thread* _this, std::initializer_list<void*> hints, F op)
+	static auto suspend_all(cpu_thread* _this, std::initializer_list<void*> hints, F op,
+		u32 src_line = __builtin_LINE(),
+		const char* src_file = __builtin_FILE(),
+		const char* src_func = __builtin_FUNCTION())
 	{
 		constexpr u8 prio = Prio > 3 ? 3 : Prio;
 
+		// Distinct lambdas get their own instantiation, but callers sharing a callable type (e.g. a function pointer) share this cache
+		static atomic_t<suspend_stat*> s_stat{};
+
+		suspend_stat* stat = s_stat.load();
+
+		if (!stat || stat->line != src_line || stat->file != src_file) [[unlikely]]
+		{
+			stat = get_suspend_stat(src_file, src_func, src_line);
+			s_stat.release(stat);
+		}
+
 		if constexpr (std::is_void_v<std::invoke_result_t<F>>)
 		{
 			suspend_work work{prio, false, false, ::size32(hints), hints.begin(), &op, nullptr, [](void* func, void*)
@@ -229,6 +270,7 @@ public:
 				std::invoke(*static_cast<F*>(func));
 			}};
 
+			work.stat = stat;
 			work.push(_this);
 			return;
 		}
@@ -241,6 +283,7 @@ public:
 				*static_cast<std::invoke_result_t<F>*>(res_buf) = std::invoke(*static_cast<F*>(func));
 			}};
 
+			work.stat = stat;
 			work.push(_this);
 			return result;
 		}
@@ -283,6 +326,9 @@ public:
 	// Send signal to the profiler(s) to flush results
 	static void flush_profilers() noexcept;
 
+	// Log suspend_all() statistics per call site and reset them
+	static void report_suspend_stats() noexcept;
+
 	template <DerivedFrom<cpu_thread> T = cpu_thread>
 	static inline T* get_current() noexcept
 	{
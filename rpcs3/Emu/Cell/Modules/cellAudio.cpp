@@ -594,10 +594,22 @@ void cell_audio_thread::advance(u64 timestamp)
 
 	lock.unlock();
 
-	for (u32 i = 0; i < queue_count; i++)
+	// Wake all receivers after the whole round, keys sharing a queue are delivered as one batch
+	lv2_obj::notify_all_t notify;
+
+	for (u32 i = 0; i < queue_count;)
 	{
-		lv2_obj::notify_all_t notify;
-		queues[i]->send(event_sources[i], CELL_AUDIO_EVENT_MIX, 0, event_data3[i]);
+		std::array<lv2_event, MAX_AUDIO_EVENT_QUEUES> batch;
+		u32 batch_size = 0;
+
+		const auto& queue = queues[i];
+
+		for (; i < queue_count && queues[i] == queue; i++)
+		{
+			batch[batch_size++] = std::make_tuple(event_sources[i], CELL_AUDIO_EVENT_MIX, 0, event_data3[i]);
+		}
+
+		queue->send(std::span<const lv2_event>(batch.data(), batch_size));
 	}
 }
 
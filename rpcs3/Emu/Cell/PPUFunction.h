@@ -4,15 +4,21 @@
 #include "PPUInterpreter.h"
 
 #include "util/v128.hpp"
+#include "util/tsc.hpp"
 
 // BIND_FUNC macro "converts" any appropriate HLE function to ppu_intrp_func_t, binding it to PPU thread context.
-#define BIND_FUNC(func, ...) (static_cast<ppu_intrp_func_t>([](ppu_thread& ppu, ppu_opcode_t, be_t<u32>* this_op, ppu_intrp_func*) {\
+#define BIND_FUNC(func, ...) BIND_FUNC_PROFILED(func, 0, __VA_ARGS__)
+
+// Same as BIND_FUNC, also reports the call to ppu_hle_profiler under the given function index (0 disables it).
+#define BIND_FUNC_PROFILED(func, prof_index, ...) (static_cast<ppu_intrp_func_t>([](ppu_thread& ppu, ppu_opcode_t, be_t<u32>* this_op, ppu_intrp_func*) {\
 	const auto old_f = ppu.current_function;\
 	if (!old_f) ppu.last_function = #func;\
 	ppu.current_function = #func;\
 	ppu.cia = vm::get_addr(this_op); \
 	std::memcpy(ppu.syscall_args, ppu.gpr + 3, sizeof(ppu.syscall_args)); \
+	const u64 prof_start = (prof_index) && ppu.hle_profiling ? utils::get_tsc() : 0;\
 	ppu_func_detail::do_call(ppu, func);\
+	if (prof_start) ppu_hle_profiler::push(prof_index, prof_start);\
 	static_cast<void>(ppu.test_stopped());\
 	auto& history = ppu.syscall_history.data[ppu.syscall_history.index++ % ppu.syscall_history.data.size()];\
 	history.cia = ppu.cia;\
@@ -316,3 +322,22 @@ template<typename T, T Func>
 u32 ppu_function_manager::registered<T, Func>::index = 0;
 
 #define FIND_FUNC(func) ppu_function_manager::get_index<decltype(&func), &func>()
+
+// Call counter and cumulative time of each HLE function (time of nested calls included), enabled with "PPU HLE Function Profiler"
+class ppu_hle_profiler
+{
+	// Call count and total nanoseconds for each function index
+	std::unique_ptr<atomic_t<u64>[]> m_data;
+	const u32 m_size;
+
+public:
+	ppu_hle_profiler();
+	ppu_hle_profiler(const ppu_hle_profiler&) = delete;
+	ppu_hle_profiler& operator=(const ppu_hle_profiler&) = delete;
+	~ppu_hle_profiler();
+
+	static void push(u32 index, u64 start_tsc) noexcept;
+
+	// Log a table of the called functions sorted by total time
+	void report() const;
+};
@@ -29,6 +29,7 @@
 #include <algorithm>
 #include <shared_mutex>
 #include "util/asm.hpp"
+#include "util/sysinfo.hpp"
 
 LOG_CHANNEL(ppu_loader);
 
@@ -134,6 +135,96 @@ void ppu_module_manager::initialize_modules()
 	}
 }
 
+ppu_hle_profiler::ppu_hle_profiler()
+	: m_size(::size32(ppu_function_manager::get()))
+{
+	m_data = std::make_unique<atomic_t<u64>[]>(m_size * 2);
+}
+
+ppu_hle_profiler::~ppu_hle_profiler()
+{
+	report();
+}
+
+void ppu_hle_profiler::push(u32 index, u64 start_tsc) noexcept
+{
+	const u64 end_tsc = utils::get_tsc();
+	const ullong freq = utils::get_tsc_freq();
+
+	auto& _this = g_fxo->get<ppu_hle_profiler>();
+
+	if (index >= _this.m_size)
+	{
+		return;
+	}
+
+	_this.m_data[index * 2] += 1;
+
+	if (freq)
+	{
+		_this.m_data[index * 2 + 1] += static_cast<u64>((end_tsc - start_tsc) * 1000'000'000. / freq);
+	}
+}
+
+void ppu_hle_profiler::report() const
+{
+	struct entry_t
+	{
+		u32 index;
+		u64 calls;
+		u64 ns;
+	};
+
+	std::vector<entry_t> entries;
+	u64 total_ns = 0;
+
+	for (u32 i = 0; i < m_size; i++)
+	{
+		if (const u64 calls = m_data[i * 2])
+		{
+			entries.push_back({i, calls, m_data[i * 2 + 1]});
+			total_ns += entries.back().ns;
+		}
+	}
+
+	if (entries.empty())
+	{
+		return;
+	}
+
+	std::sort(entries.begin(), entries.end(), [](const entry_t& a, const entry_t& b)
+	{
+		return a.ns != b.ns ? a.ns > b.ns : a.calls > b.calls;
+	});
+
+	// Function index -> (module, name)
+	std::vector<std::pair<std::string_view, std::string_view>> names(m_size);
+
+	for (const auto& [module_name, _module] : ppu_module_manager::get())
+	{
+		for (const auto& [fnid, func] : _module->functions)
+		{
+			if (func.index < m_size)
+			{
+				names[func.index] = {module_name, func.name};
+			}
+		}
+	}
+
+	std::string table;
+	fmt::append(table, "\n\t%-20s %-48s %12s %14s %8s %12s", "Module", "Function", "Calls", "Total (ms)", "Share", u8"Avg (µs)");
+
+	for (const auto& e : entries)
+	{
+		const auto [module_name, func_name] = names[e.index];
+
+		fmt::append(table, "\n\t%-20s %-48s %12u %14.3f %7.2f%% %12.3f", module_name.empty() ? "<hidden>" : module_name
+			, func_name.empty() ? fmt::format("#%u", e.index) : std::string(func_name), e.calls, e.ns / 1000'000., total_ns ? e.ns * 100. / total_ns : 0., e.ns / 1000. / e.calls);
+	}
+
+	ppu_log.notice("HLE function profile (%u functions, %.3fs total, nested calls included):%s", entries.size(), total_ns / 1000'000'000., table);
+}
+
 // Global linkage information
 struct ppu_linkage_info
 {
@@ -1063,6 +1154,11 @@ void init_ppu_functions(utils::serial* ar, bool full = false)
 	else
 		g_fxo->init<ppu_function_manager>();
 
+	if (g_cfg.core.ppu_hle_profiler)
+	{
+		g_fxo->need<ppu_hle_profiler>();
+	}
+
 	if (full)
 	{
 		// Initialize HLE modules
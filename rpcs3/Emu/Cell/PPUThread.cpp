@@ -2317,6 +2317,8 @@ ppu_thread::ppu_thread(const ppu_thread_params& param, std::string_view name, u3
 	call_history.data.resize(g_cfg.core.ppu_call_history ? call_history_max_size : 1);
 	syscall_history.data.resize(g_cfg.core.ppu_call_history ? syscall_history_max_size : 1);
 	syscall_history.count_debug_arguments = static_cast<u32>(g_cfg.core.ppu_call_history ? std::size(syscall_history.data[0].args) : 0);
+	hle_profiling = g_cfg.core.ppu_hle_profiler;
+	syscall_timing = g_cfg.core.ppu_syscall_timing;
 
 #ifdef __APPLE__
 	pthread_jit_write_protect_np(true);
@@ -2397,6 +2399,8 @@ ppu_thread::ppu_thread(utils::serial& ar)
 	call_history.data.resize(g_cfg.core.ppu_call_history ? call_history_max_size : 1);
 	syscall_history.data.resize(g_cfg.core.ppu_call_history ? syscall_history_max_size : 1);
 	syscall_history.count_debug_arguments = static_cast<u32>(g_cfg.core.ppu_call_history ? std::size(syscall_history.data[0].args) : 0);
+	hle_profiling = g_cfg.core.ppu_hle_profiler;
+	syscall_timing = g_cfg.core.ppu_syscall_timing;
 
 	serialize_common(ar);
 
@@ -291,6 +291,7 @@ public:
 	u64 start_time{0}; // Sleep start timepoint
 	u64 end_time{umax}; // Sleep end timepoint
 	s32 cancel_sleep{0}; // Flag to cancel the next lv2_obj::sleep call (when equals 2)
+	u64 syscall_sleep_tsc{0}; // TSC timepoint when the current syscall put the thread to sleep (for syscall statistics)
 	u64 syscall_args[8]{0}; // Last syscall arguments stored
 	const char* current_function{}; // Current function name for diagnosis, optimized for speed.
 	const char* last_function{}; // Sticky copy of current_function, is not cleared on function return
@@ -339,6 +340,9 @@ public:
 
 	static constexpr u32 syscall_history_max_size = 2048;
 
+	bool hle_profiling = false; // Report HLE function calls to ppu_hle_profiler
+	bool syscall_timing = false; // Record syscall latency statistics
+
 	struct hle_func_call_with_toc_info_t
 	{
 		u32 cia;
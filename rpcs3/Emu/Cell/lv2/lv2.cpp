@@ -8,6 +8,7 @@
 #include "Emu/Cell/PPUFunction.h"
 #include "Emu/Cell/ErrorCodes.h"
 #include "Emu/Cell/MFC.h"
+#include "Emu/Cell/timeout_queue.hpp"
 #include "sys_sync.h"
 #include "sys_lwmutex.h"
 #include "sys_lwcond.h"
@@ -53,6 +54,7 @@
 
 #include <optional>
 #include <deque>
+#include <numeric>
 #include "util/tsc.hpp"
 #include "util/sysinfo.hpp"
 #include "util/init_mutex.hpp"
@@ -1164,6 +1166,121 @@ stx::reset_lock acquire_reset_lock(stx::init_mutex& mtx, ppu_thread* ppu)
 	}, ppu);
 }
 
+// Per-syscall timing record: total time, blocked time, then a log2 histogram of the latency in microseconds (bucket 0 is below 1µs)
+static constexpr u32 c_syscall_time_buckets = 24;
+static constexpr u32 c_syscall_time_fields = 2 + c_syscall_time_buckets;
+
+static shared_mutex s_syscall_time_mutex;
+
+// Totals collected from the thread-local records
+static u64 s_syscall_time_acc[1024][c_syscall_time_fields]{};
+
+// Thread-local records of every thread which executed a given syscall
+static std::multimap<u32, u64*> s_syscall_time_sources;
+
+class ppu_syscall_time_local
+{
+	std::unique_ptr<u64[]> m_data[1024];
+
+public:
+	u64* get(u32 code)
+	{
+		if (!m_data[code]) [[unlikely]]
+		{
+			m_data[code] = std::make_unique<u64[]>(c_syscall_time_fields);
+
+			std::lock_guard lock(s_syscall_time_mutex);
+			s_syscall_time_sources.emplace(code, m_data[code].get());
+		}
+
+		return m_data[code].get();
+	}
+
+	~ppu_syscall_time_local()
+	{
+		std::lock_guard lock(s_syscall_time_mutex);
+
+		for (u32 code = 0; code < 1024; code++)
+		{
+			u64* const data = m_data[code].get();
+
+			if (!data)
+			{
+				continue;
+			}
+
+			for (u32 i = 0; i < c_syscall_time_fields; i++)
+			{
+				s_syscall_time_acc[code][i] += data[i];
+			}
+
+			for (auto [it, end] = s_syscall_time_sources.equal_range(code); it != end; it++)
+			{
+				if (it->second == data)
+				{
+					s_syscall_time_sources.erase(it);
+					break;
+				}
+			}
+		}
+	}
+};
+
+static thread_local ppu_syscall_time_local s_syscall_time_local;
+
+static void ppu_syscall_time_push(u32 code, u64 start_tsc, u64 sleep_tsc)
+{
+	const u64 end_tsc = utils::get_tsc();
+	const ullong freq = utils::get_tsc_freq();
+
+	if (!freq) [[unlikely]]
+	{
+		return;
+	}
+
+	const u64 ns = static_cast<u64>((end_tsc - start_tsc) * 1000'000'000. / freq);
+
+	// Everything after the thread has been put to sleep counts as blocked, including the wait for being rescheduled
+	const u64 blocked_ns = sleep_tsc ? static_cast<u64>((end_tsc - std::max(sleep_tsc, start_tsc)) * 1000'000'000. / freq) : 0;
+
+	u64* const data = s_syscall_time_local.get(code);
+	data[0] += ns;
+	data[1] += blocked_ns;
+	data[2 + std::min<u32>(64 - std::countl_zero(ns / 1000), c_syscall_time_buckets - 1)]++;
+}
+
+// Moves all thread-local records into the totals, requires s_syscall_time_mutex
+static void ppu_syscall_time_collect()
+{
+	for (auto& [code, data] : s_syscall_time_sources)
+	{
+		for (u32 i = 0; i < c_syscall_time_fields; i++)
+		{
+			s_syscall_time_acc[code][i] += atomic_storage<u64>::exchange(data[i], 0);
+		}
+	}
+}
+
+// Upper bound of the histogram bucket which contains the given fraction of calls, in microseconds
+static u64 ppu_syscall_time_percentile(const u64* buckets, u64 count, f64 fraction)
+{
+	const u64 target = std::max<u64>(static_cast<u64>(count * fraction), 1);
+
+	u64 sum = 0;
+
+	for (u32 i = 0; i < c_syscall_time_buckets; i++)
+	{
+		sum += buckets[i];
+
+		if (sum >= target)
+		{
+			return u64{1} << i;
+		}
+	}
+
+	return u64{1} << (c_syscall_time_buckets - 1);
+}
+
 class ppu_syscall_usage
 {
 	// Internal buffer
@@ -1190,9 +1307,22 @@ public:
 
 		m_stats.clear();
 
+		std::lock_guard lock(s_syscall_time_mutex);
+
+		ppu_syscall_time_collect();
+
 		for (auto&& pair : usage)
 		{
 			fmt::append(m_stats, u8"\n\t⁂ %s [%u]", ppu_get_syscall_name(pair.second), pair.first);
+
+			const u64* const data = s_syscall_time_acc[pair.second];
+			const u64 timed = std::accumulate(data + 2, data + c_syscall_time_fields, u64{0});
+
+			if (timed)
+			{
+				fmt::append(m_stats, u8": total %.3fms (blocked %.3fms), avg %.3fµs, p50 < %uµs, p99 < %uµs", data[0] / 1000'000., data[1] / 1000'000., data[0] / 1000. / timed
+					, ppu_syscall_time_percentile(data + 2, timed, 0.5), ppu_syscall_time_percentile(data + 2, timed, 0.99));
+			}
 		}
 
 		if (!m_stats.empty())
@@ -1225,6 +1355,13 @@ public:
 	~ppu_syscall_usage()
 	{
 		print_stats(true);
+
+		// Start over with the next boot, stale thread-local records are discarded as well
+		std::lock_guard lock(s_syscall_time_mutex);
+
+		ppu_syscall_time_collect();
+
+		std::memset(s_syscall_time_acc, 0, sizeof(s_syscall_time_acc));
 	}
 
 	static constexpr auto thread_name = "PPU Syscall Usage Thread"sv;
@@ -1246,7 +1383,20 @@ extern void ppu_execute_syscall(ppu_thread& ppu, u64 code)
 #ifdef __APPLE__
 			pthread_jit_write_protect_np(false);
 #endif
-			func(ppu, {}, vm::_ptr<u32>(ppu.cia), nullptr);
+			if (ppu.syscall_timing) [[unlikely]]
+			{
+				const u64 start_tsc = utils::get_tsc();
+				ppu.syscall_sleep_tsc = 0;
+
+				func(ppu, {}, vm::_ptr<u32>(ppu.cia), nullptr);
+
+				ppu_syscall_time_push(static_cast<u32>(code), start_tsc, ppu.syscall_sleep_tsc);
+			}
+			else
+			{
+				func(ppu, {}, vm::_ptr<u32>(ppu.cia), nullptr);
+			}
+
 			ppu_log.trace("Syscall '%s' (%llu) finished, r3=0x%llx", ppu_syscall_code(code), code, ppu.gpr[3]);
 
 #ifdef __APPLE__
@@ -1290,7 +1440,7 @@ thread_local DECLARE(lv2_obj::g_postpone_notify_barrier){};
 thread_local DECLARE(lv2_obj::g_to_awake);
 
 // Scheduler queue for timeouts (wait until -> thread)
-static std::deque<std::pair<u64, class cpu_thread*>> g_waiting;
+static timeout_queue<class cpu_thread*> g_waiting;
 
 // Threads which must call lv2_obj::sleep before the scheduler starts
 static std::deque<class cpu_thread*> g_to_sleep;
@@ -1524,6 +1674,11 @@ bool lv2_obj::sleep_unlocked(cpu_thread& thread, u64 timeout, u64 current_time)
 
 		ppu->raddr = 0; // Clear reservation
 		ppu->start_time = start_time;
+
+		if (ppu->syscall_timing && !ppu->syscall_sleep_tsc)
+		{
+			ppu->syscall_sleep_tsc = utils::get_tsc();
+		}
 		ppu->end_time = timeout ? start_time + std::min<u64>(timeout, ~start_time) : u64{umax};
 	}
 	else if (auto spu = thread.try_get<spu_thread>())
@@ -1543,14 +1698,7 @@ bool lv2_obj::sleep_unlocked(cpu_thread& thread, u64 timeout, u64 current_time)
 		const u64 wait_until = start_time + std::min<u64>(timeout, ~start_time);
 
 		// Register timeout if necessary
-		for (auto it = g_waiting.cbegin(), end = g_waiting.cend();; it++)
-		{
-			if (it == end || it->first > wait_until)
-			{
-				g_waiting.emplace(it, wait_until, &thread);
-				break;
-			}
-		}
+		g_waiting.schedule(wait_until, &thread, thread.timeout_slot);
 	}
 
 	return return_val;
@@ -1702,14 +1850,7 @@ bool lv2_obj::awake_unlocked(cpu_thread* cpu, s32 prio)
 		}
 
 		// Unregister timeout if necessary
-		for (auto it = g_waiting.cbegin(), end = g_waiting.cend(); it != end; it++)
-		{
-			if (it->second == cpu)
-			{
-				g_waiting.erase(it);
-				break;
-			}
-		}
+		g_waiting.cancel(cpu->timeout_slot);
 
 		ppu_log.trace("awake(): %s", cpu->id);
 		return true;
@@ -1852,17 +1993,14 @@ void lv2_obj::schedule_all(u64 current_time)
 	// Check registered timeouts
 	while (!g_waiting.empty())
 	{
-		const auto pair = &g_waiting.front();
-
 		if (!current_time)
 		{
 			current_time = get_guest_system_time();
 		}
 
-		if (pair->first <= current_time)
+		if (g_waiting.front().deadline <= current_time)
 		{
-			const auto target = pair->second;
-			g_waiting.pop_front();
+			const auto target = g_waiting.pop_front();
 
 			if (target != cpu_thread::get_current())
 			{
@@ -1883,7 +2021,7 @@ void lv2_obj::schedule_all(u64 current_time)
 		}
 		else
 		{
-			// The list is sorted so assume no more timeouts
+			// The earliest deadline is in the future so assume no more timeouts
 			break;
 		}
 	}
@@ -1948,11 +2086,12 @@ void lv2_obj::make_scheduler_ready()
 
 ppu_thread_status lv2_obj::ppu_state(ppu_thread* ppu, bool lock_idm, bool lock_lv2)
 {
-	std::optional<reader_lock> opt_lock[2];
+	std::optional<reader_lock<sharded_shared_mutex>> idm_lock;
+	std::optional<reader_lock<>> lv2_lock;
 
 	if (lock_idm)
 	{
-		opt_lock[0].emplace(id_manager::g_mutex);
+		idm_lock.emplace(id_manager::g_mutex);
 	}
 
 	if (!Emu.IsReady() ? ppu->state.all_of(cpu_flag::stop) : ppu->stop_flag_removal_protection)
@@ -1969,7 +2108,7 @@ ppu_thread_status lv2_obj::ppu_state(ppu_thread* ppu, bool lock_idm, bool lock_l
 
 	if (lock_lv2)
 	{
-		opt_lock[1].emplace(lv2_obj::g_mutex);
+		lv2_lock.emplace(lv2_obj::g_mutex);
 	}
 
 	usz pos = umax;
@@ -119,76 +119,104 @@ std::shared_ptr<lv2_event_queue> lv2_event_queue::find(u64 ipc_key)
 
 extern void resume_spu_thread_group_from_waiting(spu_thread& spu);
 
-CellError lv2_event_queue::send(lv2_event event)
+CellError lv2_event_queue::send(std::span<const lv2_event> batch, u32* sent)
 {
 	std::lock_guard lock(mutex);
 
-	if (!exists)
-	{
-		return CELL_ENOTCONN;
-	}
+	u32 count = 0;
+	bool wake = false;
 
-	if (!pq && !sq)
+	const auto deliver = [&]() -> CellError
 	{
-		if (events.size() < this->size + 0u)
+		if (!exists)
 		{
-			// Save event
-			events.emplace_back(event);
-			return {};
+			return CELL_ENOTCONN;
 		}
 
-		return CELL_EBUSY;
-	}
-
-	if (type == SYS_PPU_QUEUE)
-	{
-		// Store event in registers
-		auto& ppu = static_cast<ppu_thread&>(*schedule<ppu_thread>(pq, protocol));
-
-		if (ppu.state & cpu_flag::again)
+		for (const lv2_event& event : batch)
 		{
-			if (auto cpu = get_current_cpu_thread())
+			if (!pq && !sq)
 			{
-				cpu->state += cpu_flag::again;
-				cpu->state += cpu_flag::exit;
+				if (events.size() < this->size + 0u)
+				{
+					// Save event
+					events.emplace_back(event);
+					count++;
+					continue;
+				}
+
+				return CELL_EBUSY;
 			}
 
-			sys_event.warning("Ignored event!");
+			if (type == SYS_PPU_QUEUE)
+			{
+				// Store event in registers
+				auto& ppu = static_cast<ppu_thread&>(*schedule<ppu_thread>(pq, protocol));
 
-			// Fake error for abort
-			return CELL_EAGAIN;
-		}
+				if (ppu.state & cpu_flag::again)
+				{
+					if (auto cpu = get_current_cpu_thread())
+					{
+						cpu->state += cpu_flag::again;
+						cpu->state += cpu_flag::exit;
+					}
 
-		std::tie(ppu.gpr[4], ppu.gpr[5], ppu.gpr[6], ppu.gpr[7]) = event;
+					sys_event.warning("Ignored event!");
 
-		awake(&ppu);
-	}
-	else
-	{
-		// Store event in In_MBox
-		auto& spu = static_cast<spu_thread&>(*schedule<spu_thread>(sq, protocol));
+					// Fake error for abort
+					return CELL_EAGAIN;
+				}
 
-		if (spu.state & cpu_flag::again)
-		{
-			if (auto cpu = get_current_cpu_thread())
-			{
-				cpu->state += cpu_flag::exit + cpu_flag::again;
+				std::tie(ppu.gpr[4], ppu.gpr[5], ppu.gpr[6], ppu.gpr[7]) = event;
+
+				// Woken below with the other receivers in one scheduler pass
+				append(&ppu);
+				wake = true;
 			}
+			else
+			{
+				// Store event in In_MBox
+				auto& spu = static_cast<spu_thread&>(*schedule<spu_thread>(sq, protocol));
+
+				if (spu.state & cpu_flag::again)
+				{
+					if (auto cpu = get_current_cpu_thread())
+					{
+						cpu->state += cpu_flag::exit + cpu_flag::again;
+					}
+
+					sys_event.warning("Ignored event!");
+
+					// Fake error for abort
+					return CELL_EAGAIN;
+				}
 
-			sys_event.warning("Ignored event!");
+				const u32 data1 = static_cast<u32>(std::get<1>(event));
+				const u32 data2 = static_cast<u32>(std::get<2>(event));
+				const u32 data3 = static_cast<u32>(std::get<3>(event));
+				spu.ch_in_mbox.set_values(4, CELL_OK, data1, data2, data3);
+				resume_spu_thread_group_from_waiting(spu);
+			}
 
-			// Fake error for abort
-			return CELL_EAGAIN;
+			count++;
 		}
 
-		const u32 data1 = static_cast<u32>(std::get<1>(event));
-		const u32 data2 = static_cast<u32>(std::get<2>(event));
-		const u32 data3 = static_cast<u32>(std::get<3>(event));
-		spu.ch_in_mbox.set_values(4, CELL_OK, data1, data2, data3);
-		resume_spu_thread_group_from_waiting(spu);
+		return {};
+	};
+
+	const CellError result = deliver();
+
+	if (wake)
+	{
+		awake_all();
+	}
+
+	if (sent)
+	{
+		*sent = count;
 	}
 
-	return {};
+	return result;
 }
 
 error_code sys_event_queue_create(cpu_thread& cpu, vm::ptr<u32> equeue_id, vm::ptr<sys_event_queue_attribute_t> attr, u64 ipc_key, s32 size)
@@ -5,6 +5,7 @@
 #include "Emu/Memory/vm_ptr.h"
 
 #include <deque>
+#include <span>
 
 class cpu_thread;
 class spu_thrread;
@@ -103,13 +104,20 @@ struct lv2_event_queue final : public lv2_obj
 	static void save_ptr(utils::serial&, lv2_event_queue*);
 	static std::shared_ptr<lv2_event_queue> load_ptr(utils::serial& ar, std::shared_ptr<lv2_event_queue>& queue, std::string_view msg = {});
 
-	CellError send(lv2_event event);
+	CellError send(lv2_event event)
+	{
+		return send(std::span<const lv2_event>(&event, 1));
+	}
 
 	CellError send(u64 source, u64 d1, u64 d2, u64 d3)
 	{
 		return send(std::make_tuple(source, d1, d2, d3));
 	}
 
+	// Deliver events in order under a single lock, receivers are woken together afterwards
+	// Stops at the first event which cannot be delivered, the number of delivered events is stored in sent
+	CellError send(std::span<const lv2_event> batch, u32* sent = nullptr);
+
 	// Get event queue by its global key
 	static std::shared_ptr<lv2_event_queue> find(u64 ipc_key);
 };
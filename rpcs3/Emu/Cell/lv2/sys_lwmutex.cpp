@@ -140,9 +140,9 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 
 	ppu.gpr[3] = CELL_OK;
 
-	const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_lwmutex& mutex)
+	const auto try_signaled = [](lv2_lwmutex& mutex)
 	{
-		if (s32 signal = mutex.lv2_control.fetch_op([](auto& data)
+		return mutex.lv2_control.fetch_op([](auto& data)
 		{
 			if (data.signaled == 1)
 			{
@@ -151,7 +151,30 @@ error_code _sys_lwmutex_lock(ppu_thread& ppu, u32 lwmutex_id, u64 timeout)
 			}
 
 			return false;
-		}).first.signaled)
+		}).first.signaled;
+	};
+
+	// Uncontended fast path: consume the pending signal with a single CAS, without taking a reference to the object
+	const auto fast = idm::check<lv2_obj, lv2_lwmutex>(lwmutex_id, try_signaled);
+
+	if (!fast)
+	{
+		return CELL_ESRCH;
+	}
+
+	if (fast.ret)
+	{
+		if (fast.ret == smin)
+		{
+			ppu.gpr[3] = CELL_EBUSY;
+		}
+
+		return not_an_error(ppu.gpr[3]);
+	}
+
+	const auto mutex = idm::get<lv2_obj, lv2_lwmutex>(lwmutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_lwmutex& mutex)
+	{
+		if (s32 signal = try_signaled(mutex))
 		{
 			if (signal == smin)
 			{
@@ -321,6 +344,22 @@ error_code _sys_lwmutex_unlock(ppu_thread& ppu, u32 lwmutex_id)
 
 	sys_lwmutex.trace("_sys_lwmutex_unlock(lwmutex_id=0x%x)", lwmutex_id);
 
+	// Fast path without waiters, nothing to notify
+	const auto fast = idm::check<lv2_obj, lv2_lwmutex>(lwmutex_id, [](lv2_lwmutex& mutex)
+	{
+		return mutex.try_unlock(false);
+	});
+
+	if (!fast)
+	{
+		return CELL_ESRCH;
+	}
+
+	if (fast.ret)
+	{
+		return CELL_OK;
+	}
+
 	const auto mutex = idm::check<lv2_obj, lv2_lwmutex>(lwmutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_lwmutex& mutex)
 	{
 		if (mutex.try_unlock(false))
@@ -357,6 +396,22 @@ error_code _sys_lwmutex_unlock2(ppu_thread& ppu, u32 lwmutex_id)
 
 	sys_lwmutex.warning("_sys_lwmutex_unlock2(lwmutex_id=0x%x)", lwmutex_id);
 
+	// Fast path without waiters, nothing to notify
+	const auto fast = idm::check<lv2_obj, lv2_lwmutex>(lwmutex_id, [](lv2_lwmutex& mutex)
+	{
+		return mutex.try_unlock(true);
+	});
+
+	if (!fast)
+	{
+		return CELL_ESRCH;
+	}
+
+	if (fast.ret)
+	{
+		return CELL_OK;
+	}
+
 	const auto mutex = idm::check<lv2_obj, lv2_lwmutex>(lwmutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_lwmutex& mutex)
 	{
 		if (mutex.try_unlock(true))
@@ -140,6 +140,27 @@ error_code sys_mutex_lock(ppu_thread& ppu, u32 mutex_id, u64 timeout)
 
 	sys_mutex.trace("sys_mutex_lock(mutex_id=0x%x, timeout=0x%llx)", mutex_id, timeout);
 
+	// Uncontended fast path: a single CAS on the control word, without taking a reference to the object
+	const auto fast = idm::check<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex)
+	{
+		return mutex.try_lock(ppu);
+	});
+
+	if (!fast)
+	{
+		return CELL_ESRCH;
+	}
+
+	if (fast.ret != CELL_EBUSY)
+	{
+		if (fast.ret)
+		{
+			return fast.ret;
+		}
+
+		return CELL_OK;
+	}
+
 	const auto mutex = idm::get<lv2_obj, lv2_mutex>(mutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_mutex& mutex)
 	{
 		CellError result = mutex.try_lock(ppu);
@@ -324,6 +345,27 @@ error_code sys_mutex_unlock(ppu_thread& ppu, u32 mutex_id)
 
 	sys_mutex.trace("sys_mutex_unlock(mutex_id=0x%x)", mutex_id);
 
+	// Fast path without waiters, nothing to notify
+	const auto fast = idm::check<lv2_obj, lv2_mutex>(mutex_id, [&](lv2_mutex& mutex)
+	{
+		return mutex.try_unlock(ppu);
+	});
+
+	if (!fast)
+	{
+		return CELL_ESRCH;
+	}
+
+	if (fast.ret != CELL_EBUSY)
+	{
+		if (fast.ret)
+		{
+			return fast.ret;
+		}
+
+		return CELL_OK;
+	}
+
 	const auto mutex = idm::check<lv2_obj, lv2_mutex>(mutex_id, [&, notify = lv2_obj::notify_all_t()](lv2_mutex& mutex) -> CellError
 	{
 		auto result = mutex.try_unlock(ppu);
@@ -448,6 +448,8 @@ error_code sys_rsx_context_iomap(cpu_thread& cpu, u32 context_id, u32 io, u32 ea
 		table.io[ea + i].release((io + i) << 20);
 	}
 
+	render->iomap_table.version++;
+
 	return CELL_OK;
 }
 
@@ -489,6 +491,8 @@ error_code sys_rsx_context_iounmap(cpu_thread& cpu, u32 context_id, u32 io, u32
 		if (ea_entry + 1) table.io[ea_entry >> 20].release(-1);
 	}
 
+	render->iomap_table.version++;
+
 	return CELL_OK;
 }
 
@@ -5,6 +5,7 @@
 #include "Emu/Cell/ErrorCodes.h"
 #include "Emu/Cell/PPUThread.h"
 #include "Emu/Cell/timers.hpp"
+#include "Emu/Cell/timeout_queue.hpp"
 
 #include "util/asm.hpp"
 #include "Emu/System.h"
@@ -13,18 +14,21 @@
 #include "sys_process.h"
 
 #include <thread>
-#include <deque>
 
 LOG_CHANNEL(sys_timer);
 
 struct lv2_timer_thread
 {
 	shared_mutex mutex;
-	std::deque<std::shared_ptr<lv2_timer>> timers;
+
+	// Running timers ordered by expiration time, stale entries are dropped or rescheduled when they are reached
+	timeout_queue<std::shared_ptr<lv2_timer>> timers;
 
 	lv2_timer_thread();
 	void operator()();
 
+	void schedule(const std::shared_ptr<lv2_timer>& timer);
+
 	//SAVESTATE_INIT_POS(46); // FREE SAVESTATE_INIT_POS number
 
 	static constexpr auto thread_name = "Timer Thread"sv;
@@ -107,13 +111,24 @@ lv2_timer_thread::lv2_timer_thread()
 {
 	Emu.PostponeInitCode([this]()
 	{
-		idm::select<lv2_obj, lv2_timer>([&](u32 id, lv2_timer&)
+		std::lock_guard lock(mutex);
+
+		idm::select<lv2_obj, lv2_timer>([&](u32 id, lv2_timer& timer)
 		{
-			timers.emplace_back(idm::get_unlocked<lv2_obj, lv2_timer>(id));
+			if (timer.state == SYS_TIMER_STATE_RUN)
+			{
+				timers.schedule(timer.expire, idm::get_unlocked<lv2_obj, lv2_timer>(id), timer.timeout_slot);
+			}
 		});
 	});
 }
 
+void lv2_timer_thread::schedule(const std::shared_ptr<lv2_timer>& timer)
+{
+	std::lock_guard lock(mutex);
+	timers.schedule(timer->expire, timer, timer->timeout_slot);
+}
+
 void lv2_timer_thread::operator()()
 {
 	u64 sleep_time = 0;
@@ -143,22 +158,27 @@ void lv2_timer_thread::operator()()
 
 		const u64 _now = get_guest_system_time();
 
-		reader_lock lock(mutex);
+		std::lock_guard lock(mutex);
 
-		for (const auto& timer : timers)
+		while (!timers.empty() && thread_ctrl::state() != thread_state::aborting)
 		{
-			while (lv2_obj::check(timer))
+			if (const u64 deadline = timers.front().deadline; deadline > _now)
 			{
-				if (thread_ctrl::state() == thread_state::aborting)
-				{
-					break;
-				}
+				sleep_time = deadline - _now;
+				break;
+			}
 
+			auto timer = timers.pop_front();
+
+			while (lv2_obj::check(timer))
+			{
 				if (const u64 advised_sleep_time = timer->check(_now))
 				{
-					if (sleep_time > advised_sleep_time)
+					if (advised_sleep_time != umax)
 					{
-						sleep_time = advised_sleep_time;
+						// Periodic timer or an entry which was reached before the actual expiration time
+						u32& slot = timer->timeout_slot;
+						timers.schedule(_now + advised_sleep_time, std::move(timer), slot);
 					}
 
 					break;
@@ -174,21 +194,11 @@ error_code sys_timer_create(ppu_thread& ppu, vm::ptr<u32> timer_id)
 
 	sys_timer.warning("sys_timer_create(timer_id=*0x%x)", timer_id);
 
-	if (auto ptr = idm::make_ptr<lv2_obj, lv2_timer>())
+	// The timer thread only tracks the timer once it is started
+	if (const u32 id = idm::make<lv2_obj, lv2_timer>())
 	{
-		auto& thread = g_fxo->get<named_thread<lv2_timer_thread>>();
-		{
-			std::lock_guard lock(thread.mutex);
-
-			// Theoretically could have been destroyed by sys_timer_destroy by now
-			if (auto it = std::find(thread.timers.begin(), thread.timers.end(), ptr); it == thread.timers.end())
-			{
-				thread.timers.emplace_back(std::move(ptr));
-			}
-		}
-
 		ppu.check_state();
-		*timer_id = idm::last_id();
+		*timer_id = id;
 		return CELL_OK;
 	}
 
@@ -225,10 +235,7 @@ error_code sys_timer_destroy(ppu_thread& ppu, u32 timer_id)
 	auto& thread = g_fxo->get<named_thread<lv2_timer_thread>>();
 	std::lock_guard lock(thread.mutex);
 
-	if (auto it = std::find(thread.timers.begin(), thread.timers.end(), timer.ptr); it != thread.timers.end())
-	{
-		thread.timers.erase(it);
-	}
+	thread.timers.cancel(timer.ptr->timeout_slot);
 
 	return CELL_OK;
 }
@@ -274,7 +281,7 @@ error_code _sys_timer_start(ppu_thread& ppu, u32 timer_id, u64 base_time, u64 pe
 		return CELL_EINVAL;
 	}
 
-	const auto timer = idm::check<lv2_obj, lv2_timer>(timer_id, [&](lv2_timer& timer) -> CellError
+	const auto timer = idm::get<lv2_obj, lv2_timer>(timer_id, [&](lv2_timer& timer) -> CellError
 	{
 		std::lock_guard lock(timer.mutex);
 
@@ -334,7 +341,9 @@ error_code _sys_timer_start(ppu_thread& ppu, u32 timer_id, u64 base_time, u64 pe
 		return timer.ret;
 	}
 
-	g_fxo->get<named_thread<lv2_timer_thread>>()([]{});
+	auto& thread = g_fxo->get<named_thread<lv2_timer_thread>>();
+	thread.schedule(timer.ptr);
+	thread([]{});
 
 	return CELL_OK;
 }
@@ -0,0 +1,248 @@
+#pragma once
+
+#include "util/types.hpp"
+
+#include <vector>
+
+// 4-ary min-heap of deadlines used for lv2 timeouts and timers.
+// Every element owns a slot index that the heap keeps up to date, so rescheduling does not search.
+// Cancelling only turns the entry into a tombstone (O(1)); tombstones are dropped when they reach the front,
+// or all at once when they make up half of the heap.
+// Elements with equal deadlines are ordered by insertion. Not thread-safe, callers provide the lock.
+template <typename T>
+class timeout_queue
+{
+public:
+	static constexpr u32 invalid_slot = umax;
+
+	struct entry
+	{
+		u64 deadline;
+		u64 order;
+		T value;
+		u32* slot; // nullptr for a cancelled entry
+	};
+
+private:
+	std::vector<entry> m_heap;
+	u64 m_order = 0;
+	usz m_dead = 0;
+
+	static bool before(const entry& a, const entry& b)
+	{
+		return a.deadline != b.deadline ? a.deadline < b.deadline : a.order < b.order;
+	}
+
+	void place(u32 pos, entry&& e)
+	{
+		if (e.slot)
+		{
+			*e.slot = pos;
+		}
+
+		m_heap[pos] = std::move(e);
+	}
+
+	void sift_up(u32 pos)
+	{
+		entry e = std::move(m_heap[pos]);
+
+		while (pos)
+		{
+			const u32 parent = (pos - 1) / 4;
+
+			if (!before(e, m_heap[parent]))
+			{
+				break;
+			}
+
+			place(pos, std::move(m_heap[parent]));
+			pos = parent;
+		}
+
+		place(pos, std::move(e));
+	}
+
+	void sift_down(u32 pos)
+	{
+		const u32 size = static_cast<u32>(m_heap.size());
+		entry e = std::move(m_heap[pos]);
+
+		while (true)
+		{
+			const u32 first = pos * 4 + 1;
+
+			if (first >= size)
+			{
+				break;
+			}
+
+			u32 best = first;
+
+			for (u32 child = first + 1; child < std::min(first + 4, size); child++)
+			{
+				if (before(m_heap[child], m_heap[best]))
+				{
+					best = child;
+				}
+			}
+
+			if (!before(m_heap[best], e))
+			{
+				break;
+			}
+
+			place(pos, std::move(m_heap[best]));
+			pos = best;
+		}
+
+		place(pos, std::move(e));
+	}
+
+	void remove_at(u32 pos)
+	{
+		if (m_heap[pos].slot)
+		{
+			*m_heap[pos].slot = invalid_slot;
+		}
+		else
+		{
+			m_dead--;
+		}
+
+		const u32 last = static_cast<u32>(m_heap.size() - 1);
+
+		if (pos != last)
+		{
+			const bool moves_up = before(m_heap[last], m_heap[pos]);
+			m_heap[pos] = std::move(m_heap[last]);
+			m_heap.pop_back();
+
+			if (moves_up)
+			{
+				sift_up(pos);
+			}
+			else
+			{
+				sift_down(pos);
+			}
+
+			return;
+		}
+
+		m_heap.pop_back();
+	}
+
+	// Drop cancelled entries from the front
+	void purge()
+	{
+		while (!m_heap.empty() && !m_heap.front().slot)
+		{
+			remove_at(0);
+		}
+	}
+
+	// Drop all cancelled entries and rebuild the heap
+	void compact()
+	{
+		std::erase_if(m_heap, [](const entry& e) { return !e.slot; });
+		m_dead = 0;
+
+		for (u32 pos = 0; pos < m_heap.size(); pos++)
+		{
+			*m_heap[pos].slot = pos;
+		}
+
+		// Sift down every element which has children, starting from the last one
+		for (u32 pos = m_heap.size() > 1 ? static_cast<u32>(m_heap.size() - 2) / 4 + 1 : 0; pos--;)
+		{
+			sift_down(pos);
+		}
+	}
+
+public:
+	bool empty() const
+	{
+		return m_heap.size() == m_dead;
+	}
+
+	usz size() const
+	{
+		return m_heap.size() - m_dead;
+	}
+
+	const entry& front()
+	{
+		purge();
+		return m_heap.front();
+	}
+
+	// Inserts the element or moves it to the new deadline if it is already queued
+	void schedule(u64 deadline, T value, u32& slot)
+	{
+		if (slot != invalid_slot)
+		{
+			entry& e = m_heap[slot];
+			const bool moves_up = deadline < e.deadline;
+			e.deadline = deadline;
+			e.order = m_order++;
+
+			if (moves_up)
+			{
+				sift_up(slot);
+			}
+			else
+			{
+				sift_down(slot);
+			}
+
+			return;
+		}
+
+		m_heap.push_back(entry{deadline, m_order++, std::move(value), &slot});
+		sift_up(static_cast<u32>(m_heap.size() - 1));
+	}
+
+	// Returns false if the element was not queued
+	bool cancel(u32& slot)
+	{
+		if (slot == invalid_slot)
+		{
+			return false;
+		}
+
+		entry& e = m_heap[slot];
+		e.slot = nullptr;
+		e.value = T{};
+		slot = invalid_slot;
+
+		if (++m_dead >= 16 && m_dead * 2 >= m_heap.size())
+		{
+			compact();
+		}
+
+		return true;
+	}
+
+	T pop_front()
+	{
+		purge();
+		T value = std::move(m_heap.front().value);
+		remove_at(0);
+		return value;
+	}
+
+	void clear()
+	{
+		for (auto& e : m_heap)
+		{
+			if (e.slot)
+			{
+				*e.slot = invalid_slot;
+			}
+		}
+
+		m_heap.clear();
+		m_dead = 0;
+	}
+};
@@ -2,7 +2,7 @@
 #include "IdManager.h"
 #include "Utilities/Thread.h"
 
-shared_mutex id_manager::g_mutex;
+sharded_shared_mutex id_manager::g_mutex;
 
 namespace id_manager
 {
@@ -23,7 +23,7 @@ extern u16 serial_breathe_and_tag(utils::serial& ar, std::string_view name, bool
 namespace id_manager
 {
 	// Common global mutex
-	extern shared_mutex g_mutex;
+	extern sharded_shared_mutex g_mutex;
 
 	template <typename T>
 	constexpr std::pair<u32, u32> get_invl_range()
@@ -732,7 +732,7 @@ public:
 	{
 		static_assert((PtrSame<T, Get> && ...), "Invalid ID type combination");
 
-		[[maybe_unused]] std::conditional_t<!!Lock(), reader_lock, const shared_mutex&> lock(id_manager::g_mutex);
+		[[maybe_unused]] std::conditional_t<!!Lock(), reader_lock<sharded_shared_mutex>, const sharded_shared_mutex&> lock(id_manager::g_mutex);
 
 		using func_traits = function_traits<decltype(&decltype(std::function(std::declval<F>()))::operator())>;
 		using object_type = typename func_traits::object_type;
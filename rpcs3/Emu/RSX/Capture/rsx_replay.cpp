@@ -5,11 +5,119 @@
 #include "Emu/Cell/lv2/sys_rsx.h"
 #include "Emu/Cell/lv2/sys_memory.h"
 #include "Emu/RSX/RSXThread.h"
+#include "Emu/RSX/Common/time.hpp"
+#include "Emu/System.h"
 
 #include "util/asm.hpp"
 
 namespace rsx
 {
+	void replay_benchmark::on_frame_end(const frame_statistics_t& stats, u64 idle_time)
+	{
+		const u64 timestamp = rsx::uclock();
+
+		// The idle counter is periodically reset by the load estimator
+		const u64 idle = idle_time >= m_last_idle_time ? idle_time - m_last_idle_time : idle_time;
+		m_last_idle_time = idle_time;
+
+		if (!std::exchange(m_last_timestamp, timestamp))
+		{
+			// No reference point for the first frame
+			return;
+		}
+
+		frame_record frame{};
+		frame.iteration = current_iteration;
+		frame.draw_calls = stats.draw_calls;
+		frame.total_time = timestamp - m_last_timestamp;
+		frame.idle_time = std::min(idle, frame.total_time);
+		frame.vertex_upload_time = stats.vertex_upload_time;
+		frame.texture_cache_time = stats.textures_upload_time;
+		frame.draw_submit_time = stats.setup_time + stats.draw_exec_time;
+		frame.flip_time = stats.flip_time;
+		frame.program_lookups = stats.program_lookup_count;
+		frame.program_lookup_time = stats.program_lookup_time;
+
+		const u64 accounted = frame.idle_time + frame.vertex_upload_time + frame.texture_cache_time + frame.draw_submit_time + frame.flip_time;
+		frame.fifo_time = frame.total_time > accounted ? frame.total_time - accounted : 0;
+
+		std::lock_guard lock(m_mutex);
+		m_frames.push_back(frame);
+	}
+
+	usz replay_benchmark::frame_count() const
+	{
+		reader_lock lock(m_mutex);
+		return m_frames.size();
+	}
+
+	std::string replay_benchmark::to_json() const
+	{
+		reader_lock lock(m_mutex);
+
+		std::string result;
+		fmt::append(result, "{\n\t\"renderer\": \"%s\",\n\t\"iterations\": %u,\n\t\"frames\": [", g_cfg.video.renderer.get(), iterations);
+
+		frame_record sum{};
+		u64 counted = 0;
+
+		for (usz i = 0; i < m_frames.size(); i++)
+		{
+			const auto& f = m_frames[i];
+
+			fmt::append(result, "%s\n\t\t{\"iteration\": %u, \"draw_calls\": %u, \"total_us\": %u, \"idle_us\": %u, \"fifo_decode_us\": %u, "
+				"\"vertex_upload_us\": %u, \"texture_cache_us\": %u, \"draw_submit_us\": %u, \"flip_us\": %u, \"program_lookups\": %u, \"program_lookup_ns\": %u}", i ? "," : "",
+				f.iteration, f.draw_calls, f.total_time, f.idle_time, f.fifo_time, f.vertex_upload_time, f.texture_cache_time, f.draw_submit_time, f.flip_time,
+				f.program_lookups, f.program_lookup_time);
+
+			// The first iteration warms up the shader and texture caches
+			if (f.iteration || iterations == 1)
+			{
+				sum.draw_calls += f.draw_calls;
+				sum.total_time += f.total_time;
+				sum.idle_time += f.idle_time;
+				sum.fifo_time += f.fifo_time;
+				sum.vertex_upload_time += f.vertex_upload_time;
+				sum.texture_cache_time += f.texture_cache_time;
+				sum.draw_submit_time += f.draw_submit_time;
+				sum.flip_time += f.flip_time;
+				sum.program_lookups += f.program_lookups;
+				sum.program_lookup_time += f.program_lookup_time;
+				counted++;
+			}
+		}
+
+		const u64 div = std::max<u64>(counted, 1);
+
+		fmt::append(result, "\n\t],\n\t\"average\": {\"frames\": %u, \"draw_calls\": %u, \"total_us\": %u, \"idle_us\": %u, \"fifo_decode_us\": %u, "
+			"\"vertex_upload_us\": %u, \"texture_cache_us\": %u, \"draw_submit_us\": %u, \"flip_us\": %u, \"program_lookups\": %u, \"program_lookup_ns\": %u, "
+			"\"ns_per_program_lookup\": %u}\n}\n",
+			counted, sum.draw_calls / div, sum.total_time / div, sum.idle_time / div, sum.fifo_time / div, sum.vertex_upload_time / div,
+			sum.texture_cache_time / div, sum.draw_submit_time / div, sum.flip_time / div, sum.program_lookups / div, sum.program_lookup_time / div,
+			sum.program_lookup_time / std::max<u64>(sum.program_lookups, 1));
+
+		return result;
+	}
+
+	void replay_benchmark::report() const
+	{
+		const std::string json = to_json();
+
+		if (report_path.empty())
+		{
+			rsx_log.success("Capture replay benchmark results:\n%s", json);
+			return;
+		}
+
+		if (!fs::write_file(report_path, fs::rewrite, json))
+		{
+			rsx_log.error("Capture replay benchmark: failed to write report to '%s' (%s)", report_path, fs::g_tls_error);
+			return;
+		}
+
+		rsx_log.success("Capture replay benchmark: report written to '%s'", report_path);
+	}
+
 	be_t<u32> rsx_replay_thread::allocate_context()
 	{
 		u32 buffer_size = 4;
@@ -173,8 +281,20 @@ namespace rsx
 
 		auto fifo_stops = alloc_write_fifo(context_id);
 
-		while (thread_ctrl::state() != thread_state::aborting)
+		const auto benchmark = g_fxo->try_get<replay_benchmark>();
+
+		for (u32 iteration = 0; thread_ctrl::state() != thread_state::aborting; iteration++)
 		{
+			if (benchmark)
+			{
+				if (iteration == benchmark->iterations)
+				{
+					break;
+				}
+
+				benchmark->current_iteration.release(iteration);
+			}
+
 			// Load registers while the RSX is still idle
 			method_registers = frame->reg_state;
 			atomic_fence_seq_cst();
@@ -237,10 +357,34 @@ namespace rsx
 				render->request_emu_flip(1u);
 			}
 
+			if (benchmark)
+			{
+				// Run back-to-back, pausing would show up as idle time
+				continue;
+			}
+
 			// random pause to not destroy gpu
 			thread_ctrl::wait_for(10'000);
 		}
 
+		if (benchmark && thread_ctrl::state() != thread_state::aborting)
+		{
+			// Wait for the last flip to be accounted
+			const usz expected = std::max<usz>(benchmark->iterations, 1) - 1;
+
+			for (u32 i = 0; i < 100 && benchmark->frame_count() < expected; i++)
+			{
+				thread_ctrl::wait_for(10'000);
+			}
+
+			benchmark->report();
+
+			Emu.CallFromMainThread([]()
+			{
+				Emu.GracefulShutdown();
+			});
+		}
+
 		get_current_cpu_thread()->state += (cpu_flag::exit + cpu_flag::wait);
 	}
 }
@@ -2,6 +2,8 @@
 
 #include "Emu/CPU/CPUThread.h"
 #include "Emu/RSX/rsx_methods.h"
+#include "Emu/RSX/Core/RSXDisplay.h"
+#include "Utilities/mutex.h"
 
 #include <unordered_map>
 #include <unordered_set>
@@ -117,6 +119,48 @@ namespace rsx
 	};
 
 
+	// Collects per-frame CPU time while a capture is replayed in benchmark mode
+	struct replay_benchmark
+	{
+		struct frame_record
+		{
+			u32 iteration;
+			u32 draw_calls;
+			u64 total_time;          // Wall time since the previous frame end
+			u64 idle_time;           // Time the RSX thread spent waiting for work
+			u64 fifo_time;           // Everything not accounted below (FIFO decode, method handlers)
+			u64 vertex_upload_time;
+			u64 texture_cache_time;
+			u64 draw_submit_time;    // Draw setup and execution
+			u64 flip_time;
+			u32 program_lookups;     // Pipeline cache lookups replayed this frame
+			u64 program_lookup_time; // In nanoseconds, also part of draw_submit_time
+		};
+
+		const u32 iterations;
+		const std::string report_path;
+
+		atomic_t<u32> current_iteration = 0;
+
+		replay_benchmark(u32 iterations, std::string report_path)
+			: iterations(iterations), report_path(std::move(report_path))
+		{
+		}
+
+		// Called by the RSX thread before the frame statistics are reset
+		void on_frame_end(const frame_statistics_t& stats, u64 idle_time);
+
+		usz frame_count() const;
+		std::string to_json() const;
+		void report() const;
+
+	private:
+		mutable shared_mutex m_mutex;
+		std::vector<frame_record> m_frames;
+		u64 m_last_timestamp = 0;
+		u64 m_last_idle_time = 0;
+	};
+
 	class rsx_replay_thread : public cpu_thread
 	{
 		struct rsx_context
@@ -0,0 +1,121 @@
+#include "stdafx.h"
+#include "frame_arena.h"
+
+#include "util/asm.hpp"
+
+#include <new>
+
+namespace rsx
+{
+	namespace
+	{
+		thread_local frame_arena* s_current_arena = nullptr;
+	}
+
+	void frame_arena::make_current() noexcept
+	{
+		s_current_arena = this;
+	}
+
+	frame_arena* frame_arena::get_current() noexcept
+	{
+		return s_current_arena;
+	}
+
+	frame_arena::chunk* frame_arena::find_chunk(const void* ptr) noexcept
+	{
+		const auto address = static_cast<const u8*>(ptr);
+
+		for (auto& c : m_chunks)
+		{
+			if (address >= c.data.get() && address < c.data.get() + chunk_size)
+			{
+				return &c;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void* frame_arena::allocate(usz size, usz alignment)
+	{
+		if (size && size <= max_allocation_size && alignment <= 64)
+		{
+			for (; m_current_chunk < max_chunks; m_current_chunk++)
+			{
+				if (m_current_chunk == m_chunks.size())
+				{
+					m_chunks.push_back({ std::make_unique<u8[]>(chunk_size) });
+				}
+
+				auto& c = m_chunks[m_current_chunk];
+				const usz base = reinterpret_cast<usz>(c.data.get());
+				const usz offset = utils::align(base + c.offset, alignment) - base;
+
+				if (offset + size <= chunk_size)
+				{
+					m_stats.used += (offset + size) - c.offset;
+					m_stats.peak = std::max(m_stats.peak, m_stats.used);
+					m_live_allocations++;
+
+					c.offset = offset + size;
+					return c.data.get() + offset;
+				}
+			}
+
+			// All chunks are exhausted for this frame
+			m_current_chunk = max_chunks - 1;
+		}
+
+		m_stats.fallback_count++;
+		m_total_fallback_count++;
+		return ::operator new(size, std::align_val_t{ alignment });
+	}
+
+	void frame_arena::deallocate(void* ptr, usz size, usz alignment) noexcept
+	{
+		if (!ptr)
+		{
+			return;
+		}
+
+		chunk* c = find_chunk(ptr);
+		if (!c)
+		{
+			::operator delete(ptr, std::align_val_t{ alignment });
+			return;
+		}
+
+		// The most recent allocation can be handed back right away, this covers most scoped temporaries
+		if (static_cast<u8*>(ptr) + size == c->data.get() + c->offset)
+		{
+			c->offset -= size;
+		}
+
+		m_live_allocations--;
+	}
+
+	void frame_arena::reset() noexcept
+	{
+		if (m_live_allocations)
+		{
+			m_deferred_reset_count++;
+			return;
+		}
+
+		for (usz i = 0; i <= m_current_chunk && i < m_chunks.size(); i++)
+		{
+			m_chunks[i].offset = 0;
+		}
+
+		m_current_chunk = 0;
+	}
+
+	frame_arena::statistics frame_arena::take_statistics() noexcept
+	{
+		const auto result = m_stats;
+		m_stats.used = 0;
+		m_stats.fallback_count = 0;
+		return result;
+	}
+}
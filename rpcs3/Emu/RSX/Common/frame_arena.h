@@ -0,0 +1,124 @@
+#pragma once
+
+#include <util/types.hpp>
+
+#include <list>
+#include <memory>
+#include <vector>
+
+namespace rsx
+{
+	// Bump allocator for short-lived CPU side buffers of the RSX thread.
+	// Memory is carved out of a few reusable chunks and rewound as a whole once the frame has been presented.
+	class frame_arena
+	{
+	public:
+		struct statistics
+		{
+			u64 used = 0;           // Bytes handed out during the frame
+			u64 peak = 0;           // Highest per-frame usage since boot
+			u32 fallback_count = 0; // Requests that had to be served by the heap during the frame
+		};
+
+		static constexpr usz chunk_size = 0x100000;
+		static constexpr usz max_chunks = 16;
+
+		// Anything larger is unlikely to be transient and would waste most of a chunk
+		static constexpr usz max_allocation_size = chunk_size / 4;
+
+		frame_arena() = default;
+		frame_arena(const frame_arena&) = delete;
+		frame_arena& operator=(const frame_arena&) = delete;
+
+		void* allocate(usz size, usz alignment);
+		void deallocate(void* ptr, usz size, usz alignment) noexcept;
+
+		// Rewinds all chunks. Skipped if allocations are still alive, they will be picked up by the next reset.
+		void reset() noexcept;
+
+		statistics take_statistics() noexcept;
+
+		u64 get_total_fallback_count() const { return m_total_fallback_count; }
+		u32 get_deferred_reset_count() const { return m_deferred_reset_count; }
+
+		// Binds the arena to the calling thread. Allocators created on other threads use the heap.
+		void make_current() noexcept;
+		static frame_arena* get_current() noexcept;
+
+	private:
+		struct chunk
+		{
+			std::unique_ptr<u8[]> data;
+			usz offset = 0;
+		};
+
+		std::vector<chunk> m_chunks;
+		usz m_current_chunk = 0;
+		usz m_live_allocations = 0;
+
+		statistics m_stats{};
+		u64 m_total_fallback_count = 0;
+		u32 m_deferred_reset_count = 0;
+
+		chunk* find_chunk(const void* ptr) noexcept;
+	};
+
+	// STL allocator drawing from the arena bound to the constructing thread
+	template <typename T>
+	class frame_allocator
+	{
+		template <typename U>
+		friend class frame_allocator;
+
+		frame_arena* m_arena;
+
+	public:
+		using value_type = T;
+		using propagate_on_container_copy_assignment = std::true_type;
+		using propagate_on_container_move_assignment = std::true_type;
+		using propagate_on_container_swap = std::true_type;
+		using is_always_equal = std::false_type;
+
+		frame_allocator() noexcept
+			: m_arena(frame_arena::get_current())
+		{}
+
+		template <typename U>
+		frame_allocator(const frame_allocator<U>& other) noexcept
+			: m_arena(other.m_arena)
+		{}
+
+		T* allocate(usz count)
+		{
+			if (!m_arena)
+			{
+				return std::allocator<T>{}.allocate(count);
+			}
+
+			return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* ptr, usz count) noexcept
+		{
+			if (!m_arena)
+			{
+				std::allocator<T>{}.deallocate(ptr, count);
+				return;
+			}
+
+			m_arena->deallocate(ptr, count * sizeof(T), alignof(T));
+		}
+
+		template <typename U>
+		bool operator==(const frame_allocator<U>& other) const noexcept
+		{
+			return m_arena == other.m_arena;
+		}
+	};
+
+	template <typename T>
+	using frame_vector = std::vector<T, frame_allocator<T>>;
+
+	template <typename T>
+	using frame_list = std::list<T, frame_allocator<T>>;
+}
@@ -3,7 +3,9 @@
 #include <util/types.hpp>
 #include "Utilities/address_range.h"
 
+#include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 namespace rsx
 {
@@ -11,20 +13,23 @@ namespace rsx
 	class ranged_map
 	{
 	protected:
-		struct block_metadata_t
+		struct interval_t
 		{
-			u32 id = umax;             // ID of the matadata blob
-			u32 head_block = umax;     // Earliest block that may have an object that intersects with the data at the block with ID 'id'
+			u32 start;
+			u32 end;
+			u32 reach;                 // Highest end address of this and all preceding intervals
 		};
 
 	public:
 		using inner_type = typename std::unordered_map<u32, T>;
 		using outer_type = typename std::array<inner_type, 0x100000000ull / BlockSize>;
-		using metadata_array = typename std::array<block_metadata_t, 0x100000000ull / BlockSize>;
 
 	protected:
 		outer_type m_data;
-		metadata_array m_metadata;
+
+		// Interval index sorted by start address. Since 'reach' never decreases along the array,
+		// the first interval that can overlap a query is found with a binary search.
+		std::vector<interval_t> m_intervals;
 
 		static inline u32 block_for(u32 address)
 		{
@@ -36,12 +41,46 @@ namespace rsx
 			return block_id * BlockSize;
 		}
 
-		void broadcast_insert(const utils::address_range& range)
+		usz interval_index(u32 start) const
+		{
+			return std::lower_bound(m_intervals.begin(), m_intervals.end(), start, [](const interval_t& e, u32 value)
+			{
+				return e.start < value;
+			}) - m_intervals.begin();
+		}
+
+		void update_reach(usz from)
 		{
-			const auto head_block = block_for(range.start);
-			for (auto meta = &m_metadata[head_block]; meta <= &m_metadata[block_for(range.end)]; ++meta)
+			u32 reach = from ? m_intervals[from - 1].reach : 0;
+			for (auto e = m_intervals.begin() + from; e != m_intervals.end(); ++e)
 			{
-				meta->head_block = std::min(head_block, meta->head_block);
+				reach = std::max(reach, e->end);
+				e->reach = reach;
+			}
+		}
+
+		void index_insert(const utils::address_range& range)
+		{
+			const auto pos = interval_index(range.start);
+			if (pos < m_intervals.size() && m_intervals[pos].start == range.start)
+			{
+				m_intervals[pos].end = range.end;
+			}
+			else
+			{
+				m_intervals.insert(m_intervals.begin() + pos, interval_t{ range.start, range.end, 0 });
+			}
+
+			update_reach(pos);
+		}
+
+		void index_erase(u32 start)
+		{
+			const auto pos = interval_index(start);
+			if (pos < m_intervals.size() && m_intervals[pos].start == start)
+			{
+				m_intervals.erase(m_intervals.begin() + pos);
+				update_reach(pos);
 			}
 		}
 
@@ -54,19 +93,29 @@ namespace rsx
 
 		protected:
 			inner_type* m_current = nullptr;
-			inner_type* m_end = nullptr;
 
-			inner_type* m_data_ptr = nullptr;
-			block_metadata_t* m_metadata_ptr = nullptr;
+			super* m_parent = nullptr;
+			usz m_position = 0;
+			u32 m_query_start = 0;
+			u32 m_query_end = 0;
 			inner_iterator m_it{};
 
 			void forward_scan()
 			{
-				while (m_current < m_end)
+				const auto& intervals = m_parent->m_intervals;
+
+				for (; m_position < intervals.size(); ++m_position)
 				{
-					m_it = (++m_current)->begin();
-					if (m_it != m_current->end()) [[ likely ]]
+					const auto& e = intervals[m_position];
+					if (e.start > m_query_end)
 					{
+						break;
+					}
+
+					if (e.end >= m_query_start)
+					{
+						m_current = &m_parent->m_data[block_for(e.start)];
+						m_it = m_current->find(e.start);
 						return;
 					}
 				}
@@ -83,46 +132,44 @@ namespace rsx
 					return;
 				}
 
-				if (++m_it != m_current->end()) [[ likely ]]
-				{
-					return;
-				}
-
+				++m_position;
 				forward_scan();
 			}
 
-			void begin_range(u32 address, inner_iterator& where)
+			void begin_range(usz position, inner_type* block, inner_iterator& where)
 			{
-				m_current = &m_data_ptr[address / BlockSize];
-				m_end = m_current;
+				// Single element, the query degenerates to its start address
+				m_position = position;
+				m_query_start = m_query_end = where->first;
+				m_current = block;
 				m_it = where;
 			}
 
 			void begin_range(const utils::address_range& range)
 			{
-				const auto start_block_id = range.start / BlockSize;
-				const auto& metadata = m_metadata_ptr[start_block_id];
-				m_current = &m_data_ptr[std::min(start_block_id, metadata.head_block)];
-				m_end = &m_data_ptr[range.end / BlockSize];
+				const auto& intervals = m_parent->m_intervals;
+				m_query_start = range.start;
+				m_query_end = range.end;
+				m_position = std::partition_point(intervals.begin(), intervals.end(), [&](const interval_t& e)
+				{
+					return e.reach < range.start;
+				}) - intervals.begin();
 
-				--m_current;
 				forward_scan();
 			}
 
 			void erase()
 			{
-				m_it = m_current->erase(m_it);
-				if (m_it != m_current->end())
-				{
-					return;
-				}
+				m_current->erase(m_it);
+				m_parent->m_intervals.erase(m_parent->m_intervals.begin() + m_position);
+				m_parent->update_reach(m_position);
 
+				// The next interval has moved into the current position
 				forward_scan();
 			}
 
 			iterator(super* parent):
-				m_data_ptr(parent->m_data.data()),
-				m_metadata_ptr(parent->m_metadata.data())
+				m_parent(parent)
 			{}
 
 		public:
@@ -172,14 +219,11 @@ namespace rsx
 		};
 
 	public:
-		ranged_map()
-		{
-			std::for_each(m_metadata.begin(), m_metadata.end(), [&](auto& meta) { meta.id = static_cast<u32>(&meta - m_metadata.data()); });
-		}
+		ranged_map() = default;
 
 		void emplace(const utils::address_range& range, T&& value)
 		{
-			broadcast_insert(range);
+			index_insert(range);
 			m_data[block_for(range.start)].insert_or_assign(range.start, std::forward<T>(value));
 		}
 
@@ -203,7 +247,7 @@ namespace rsx
 			if (auto found = block.find(key);
 				found != block.end())
 			{
-				ret.begin_range(key, found);
+				ret.begin_range(interval_index(key), &block, found);
 			}
 
 			return ret;
@@ -217,7 +261,10 @@ namespace rsx
 
 		void erase(u32 address)
 		{
-			m_data[block_for(address)].erase(address);
+			if (m_data[block_for(address)].erase(address))
+			{
+				index_erase(address);
+			}
 		}
 
 		iterator begin_range(const utils::address_range& range)
@@ -227,6 +274,11 @@ namespace rsx
 			return ret;
 		}
 
+		iterator begin()
+		{
+			return begin_range(utils::address_range::start_end(0, umax));
+		}
+
 		iterator end()
 		{
 			iterator ret = { this };
@@ -239,6 +291,8 @@ namespace rsx
 			{
 				e.clear();
 			}
+
+			m_intervals.clear();
 		}
 	};
 }
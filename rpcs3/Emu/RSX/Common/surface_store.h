@@ -2,6 +2,7 @@
 
 #include "surface_utils.h"
 #include "simple_array.hpp"
+#include "frame_arena.h"
 #include "ranged_map.hpp"
 #include "surface_cache_dma.hpp"
 #include "../gcm_enums.h"
@@ -58,6 +59,9 @@ namespace rsx
 
 		surface_cache_dma_map m_dma_block;
 
+		// Scratch coverage map for the duplicate removal fallback, kept to avoid reallocating it on every call
+		std::vector<u8> m_duplicate_marker;
+
 		bool m_invalidate_on_write = false;
 
 		rsx::surface_raster_type m_active_raster_type = rsx::surface_raster_type::linear;
@@ -629,10 +633,10 @@ namespace rsx
 			invalidated_resources.push_back(std::move(storage));
 		}
 
-		int remove_duplicates_fast_impl(std::vector<surface_overlap_info>& sections, const rsx::address_range& range)
+		int remove_duplicates_fast_impl(rsx::frame_vector<surface_overlap_info>& sections, const rsx::address_range& range)
 		{
 			// Range tests to check for gaps
-			std::list<utils::address_range> m_ranges;
+			rsx::frame_list<utils::address_range> m_ranges;
 			bool invalidate_sections = false;
 			int removed_count = 0;
 
@@ -696,7 +700,7 @@ namespace rsx
 			return removed_count;
 		}
 
-		void remove_duplicates_fallback_impl(std::vector<surface_overlap_info>& sections, const rsx::address_range& range)
+		void remove_duplicates_fallback_impl(rsx::frame_vector<surface_overlap_info>& sections, const rsx::address_range& range)
 		{
 			// Originally used to debug crashes but this function breaks often enough that I'll leave the checks in for now.
 			// Safe to remove after some time if no asserts are reported.
@@ -704,7 +708,8 @@ namespace rsx
 
 			// Generic painter's algorithm to detect obsolete sections
 			ensure(range.length() < 64 * 0x100000);
-			std::vector<u8> marker(range.length() + sizeof(overrun_cookie_value), 0);
+			auto& marker = m_duplicate_marker;
+			marker.assign(range.length() + sizeof(overrun_cookie_value), 0);
 
 			// Tag end
 			write_to_ptr(marker, range.length(), overrun_cookie_value);
@@ -826,6 +831,12 @@ namespace rsx
 
 			// Verify no OOB
 			ensure(read_from_ptr<u32>(marker, range.length()) == overrun_cookie_value);
+
+			if (marker.capacity() > 16 * 0x100000)
+			{
+				// Do not hold on to the rare very large maps
+				marker = {};
+			}
 		}
 
 	protected:
@@ -1087,10 +1098,10 @@ namespace rsx
 		}
 
 		template <typename commandbuffer_type>
-		std::vector<surface_overlap_info> get_merged_texture_memory_region(commandbuffer_type& cmd, u32 texaddr, u32 required_width, u32 required_height, u32 required_pitch, u8 required_bpp, rsx::surface_access access)
+		rsx::frame_vector<surface_overlap_info> get_merged_texture_memory_region(commandbuffer_type& cmd, u32 texaddr, u32 required_width, u32 required_height, u32 required_pitch, u8 required_bpp, rsx::surface_access access)
 		{
-			std::vector<surface_overlap_info> result;
-			std::vector<std::pair<u32, bool>> dirty;
+			rsx::frame_vector<surface_overlap_info> result;
+			rsx::frame_vector<std::pair<u32, bool>> dirty;
 
 			const auto surface_internal_pitch = (required_width * required_bpp);
 
@@ -1235,7 +1246,7 @@ namespace rsx
 			return result;
 		}
 
-		void check_for_duplicates(std::vector<surface_overlap_info>& sections)
+		void check_for_duplicates(rsx::frame_vector<surface_overlap_info>& sections)
 		{
 			utils::address_range test_range;
 			for (const auto& section : sections)
@@ -1294,9 +1305,9 @@ namespace rsx
 		void invalidate_all()
 		{
 			// Unbind and invalidate all resources
-			auto free_resource_list = [&](auto &data, const utils::address_range& range)
+			auto free_resource_list = [&](auto &data)
 			{
-				for (auto it = data.begin_range(range); it != data.end(); ++it)
+				for (auto it = data.begin(); it != data.end(); ++it)
 				{
 					invalidate(it->second);
 				}
@@ -1304,8 +1315,8 @@ namespace rsx
 				data.clear();
 			};
 
-			free_resource_list(m_render_targets_storage, m_render_targets_memory_range);
-			free_resource_list(m_depth_stencil_storage, m_depth_stencil_memory_range);
+			free_resource_list(m_render_targets_storage);
+			free_resource_list(m_depth_stencil_storage);
 
 			ensure(m_active_memory_used == 0);
 
@@ -1383,9 +1394,9 @@ namespace rsx
 
 		void collapse_dirty_surfaces(command_list_type cmd, problem_severity severity)
 		{
-			auto process_list_function = [&](surface_ranged_map& data, const utils::address_range& range)
+			auto process_list_function = [&](surface_ranged_map& data)
 			{
-				for (auto It = data.begin_range(range); It != data.end();)
+				for (auto It = data.begin(); It != data.end();)
 				{
 					auto surface = Traits::get(It->second);
 					if (surface->dirty())
@@ -1410,8 +1421,8 @@ namespace rsx
 				}
 			};
 
-			process_list_function(m_render_targets_storage, m_render_targets_memory_range);
-			process_list_function(m_depth_stencil_storage, m_depth_stencil_memory_range);
+			process_list_function(m_render_targets_storage);
+			process_list_function(m_depth_stencil_storage);
 		}
 
 		virtual bool handle_memory_pressure(command_list_type cmd, problem_severity severity)
@@ -3,6 +3,7 @@
 #include "texture_cache_utils.h"
 #include "texture_cache_predictor.h"
 #include "texture_cache_helpers.h"
+#include "timeline.h"
 
 #include <unordered_map>
 
@@ -417,6 +418,40 @@ namespace rsx
 			}
 		};
 
+		/**
+		 * Result of a previous upload_texture lookup.
+		 * Valid for as long as the storage blocks covering the lookup range and the surface cache are unchanged.
+		 */
+		struct texture_lookup_memo
+		{
+			bool valid = false;
+			image_section_attributes_t attributes;
+			u32 encoded_remap;
+			texture_channel_remap_t remap;
+			size3f scale;
+			rsx::texture_dimension_extended dimension;
+
+			u64 storage_epoch;
+			u64 surface_cache_tag;
+			u64 surface_write_tag;
+
+			sampled_image_descriptor result;
+
+			bool matches(const image_section_attributes_t& attr, u32 _encoded_remap, const texture_channel_remap_t& _remap, const size3f& _scale,
+				rsx::texture_dimension_extended _dimension, u64 _storage_epoch, u64 _surface_cache_tag, u64 _surface_write_tag) const
+			{
+				return valid &&
+					storage_epoch == _storage_epoch &&
+					surface_cache_tag == _surface_cache_tag &&
+					surface_write_tag == _surface_write_tag &&
+					attributes == attr &&
+					encoded_remap == _encoded_remap &&
+					remap == _remap &&
+					dimension == _dimension &&
+					scale.width == _scale.width && scale.height == _scale.height && scale.depth == _scale.depth;
+			}
+		};
+
 
 	protected:
 
@@ -432,6 +467,10 @@ namespace rsx
 
 		atomic_t<u64> m_cache_update_tag = {0};
 
+		// Lookups are only issued from the RSX thread, the memo table itself needs no synchronization
+		static constexpr u32 lookup_memo_size = 32;
+		std::array<texture_lookup_memo, lookup_memo_size> m_lookup_memo;
+
 		address_range read_only_range;
 		address_range no_access_range;
 
@@ -456,6 +495,7 @@ namespace rsx
 		atomic_t<u32> m_texture_upload_calls_this_frame = { 0 };
 		atomic_t<u32> m_texture_upload_misses_this_frame = { 0 };
 		atomic_t<u32> m_texture_copies_ellided_this_frame = { 0 };
+		atomic_t<u32> m_texture_memo_hits_this_frame = { 0 };
 		static const u32 m_predict_max_flushes_per_frame = 50; // Above this number the predictions are disabled
 
 		// Invalidation
@@ -1161,9 +1201,9 @@ namespace rsx
 		}
 
 		template <bool check_unlocked = false>
-		std::vector<section_storage_type*> find_texture_from_range(const address_range &test_range, u32 required_pitch = 0, u32 context_mask = 0xFF)
+		rsx::frame_vector<section_storage_type*> find_texture_from_range(const address_range &test_range, u32 required_pitch = 0, u32 context_mask = 0xFF)
 		{
-			std::vector<section_storage_type*> results;
+			rsx::frame_vector<section_storage_type*> results;
 
 			for (auto It = m_storage.range_begin(test_range, full_range, check_unlocked); It != m_storage.range_end(); It++)
 			{
@@ -1869,8 +1909,8 @@ namespace rsx
 					}
 				}
 
-				std::vector<typename SurfaceStoreType::surface_overlap_info> overlapping_fbos;
-				std::vector<section_storage_type*> overlapping_locals;
+				rsx::frame_vector<typename SurfaceStoreType::surface_overlap_info> overlapping_fbos;
+				rsx::frame_vector<section_storage_type*> overlapping_locals;
 
 				auto fast_fbo_check = [&]() -> sampled_image_descriptor
 				{
@@ -2339,9 +2379,24 @@ namespace rsx
 			}
 
 			const auto lookup_range = utils::address_range::start_length(attributes.address, attributes.pitch * required_surface_height);
+			const auto encoded_remap = tex.remap();
+			const auto decoded_remap = tex.decoded_remap();
+
+			// Samplers are rebound for every draw in many titles. If nothing overlapping the lookup range changed since the
+			// last bind, return the previous result without taking the cache lock so binds do not queue behind invalidations.
+			// The epoch is sampled before searching; a writer racing with the search only makes the stored result stale.
+			const u64 storage_epoch = m_storage.get_range_epoch(lookup_range);
+			auto& memo = m_lookup_memo[(attributes.address >> 8) % lookup_memo_size];
+
+			if (memo.matches(attributes, encoded_remap, decoded_remap, scale, extended_dimension, storage_epoch, m_rtts.cache_tag, m_rtts.write_tag))
+			{
+				m_texture_memo_hits_this_frame++;
+				return memo.result;
+			}
+
 			reader_lock lock(m_cache_mutex);
 
-			auto result = fast_texture_search(cmd, attributes, scale, tex.remap(), tex.decoded_remap(),
+			auto result = fast_texture_search(cmd, attributes, scale, encoded_remap, decoded_remap,
 				options, lookup_range, extended_dimension, m_rtts,
 				std::forward<Args>(extras)...);
 
@@ -2366,6 +2421,14 @@ namespace rsx
 
 				if (subsurface_count == 1)
 				{
+					// Only plain section hits are remembered. Small sections are protected by hashing, which is only re-evaluated on lookup.
+					if (result.image_handle && !result.is_cyclic_reference &&
+						lookup_range.length() >= 4096 &&
+						(result.upload_context == rsx::texture_upload_context::shader_read || result.upload_context == rsx::texture_upload_context::blit_engine_dst))
+					{
+						memo = { true, attributes, encoded_remap, decoded_remap, scale, extended_dimension, storage_epoch, m_rtts.cache_tag, m_rtts.write_tag, result };
+					}
+
 					return result;
 				}
 
@@ -2416,7 +2479,7 @@ namespace rsx
 					}
 
 					const auto range = utils::address_range::start_length(attr2.address, attr2.pitch * attr2.height);
-					auto ret = fast_texture_search(cmd, attr2, scale, tex.remap(), tex.decoded_remap(),
+					auto ret = fast_texture_search(cmd, attr2, scale, encoded_remap, decoded_remap,
 						options, range, extended_dimension, m_rtts, std::forward<Args>(extras)...);
 
 					if (!ret.validate() ||
@@ -2462,6 +2525,7 @@ namespace rsx
 
 			// Do direct upload from CPU as the last resort
 			m_texture_upload_misses_this_frame++;
+			rsx::timeline::scoped_event miss_event(rsx::timeline::event_type::texture_cache_miss, attributes.address);
 
 			const auto subresources_layout = get_subresources_layout(tex);
 			const auto format_class = classify_format(attributes.gcm_format);
@@ -3521,6 +3585,7 @@ namespace rsx
 			m_texture_upload_calls_this_frame.store(0u);
 			m_texture_upload_misses_this_frame.store(0u);
 			m_texture_copies_ellided_this_frame.store(0u);
+			m_texture_memo_hits_this_frame.store(0u);
 		}
 
 		void on_flush()
@@ -3608,5 +3673,10 @@ namespace rsx
 		{
 			return m_texture_copies_ellided_this_frame;
 		}
+
+		u32 get_texture_memo_hits_this_frame() const
+		{
+			return m_texture_memo_hits_this_frame;
+		}
 	};
 }
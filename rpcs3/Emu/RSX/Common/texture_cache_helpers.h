@@ -2,6 +2,7 @@
 
 #include "../rsx_utils.h"
 #include "TextureUtils.h"
+#include "frame_arena.h"
 
 namespace rsx
 {
@@ -60,6 +61,8 @@ namespace rsx
 		u8  bpp;
 		bool swizzled;
 		bool edge_clamped;
+
+		bool operator==(const image_section_attributes_t&) const = default;
 	};
 
 	struct blit_op_result
@@ -248,12 +251,12 @@ namespace rsx
 			return { false, 0, dst_dimensions.width, dst_dimensions.height };
 		}
 
-		template<typename commandbuffer_type, typename section_storage_type, typename copy_region_type, typename surface_store_list_type>
+		template<typename commandbuffer_type, typename copy_region_type, typename surface_store_list_type, typename local_list_type>
 		void gather_texture_slices(
 			commandbuffer_type& cmd,
 			std::vector<copy_region_type>& out,
 			const surface_store_list_type& fbos,
-			const std::vector<section_storage_type*>& local,
+			const local_list_type& local,
 			const image_section_attributes_t& attr,
 			u16 count, bool /*is_depth*/)
 		{
@@ -265,7 +268,7 @@ namespace rsx
 				u32 index; // Index in list
 			};
 
-			std::vector<sort_helper> sort_list;
+			rsx::frame_vector<sort_helper> sort_list;
 
 			if (!fbos.empty() && !local.empty())
 			{
@@ -739,10 +742,10 @@ namespace rsx
 					rsx::texture_dimension_extended::texture_dimension_cubemap, decoded_remap };
 		}
 
-		template <typename sampled_image_descriptor, typename commandbuffer_type, typename surface_store_list_type, typename section_storage_type>
+		template <typename sampled_image_descriptor, typename commandbuffer_type, typename surface_store_list_type, typename local_list_type>
 		sampled_image_descriptor merge_cache_resources(
 			commandbuffer_type& cmd,
-			const surface_store_list_type& fbos, const std::vector<section_storage_type*>& local,
+			const surface_store_list_type& fbos, const local_list_type& local,
 			const image_section_attributes_t& attr,
 			const size3f& scale,
 			texture_dimension_extended extended_dimension,
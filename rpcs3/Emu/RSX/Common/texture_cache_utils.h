@@ -239,6 +239,26 @@ namespace rsx
 		atomic_t<u32> unreleased_count = 0;
 		ranged_storage_type *m_storage = nullptr;
 
+		// Incremented whenever a section overlapping this block changes in a way visible to lookups.
+		// Lets lock-free readers validate results computed earlier instead of taking the cache lock.
+		atomic_t<u64> m_epoch = 0;
+
+		inline void publish_section_change(const section_storage_type &section)
+		{
+			m_epoch++;
+
+			if (!section.valid_range())
+			{
+				return;
+			}
+
+			u32 end = section.get_section_range().end;
+			for (auto *block = next_block(); block != nullptr && end >= block->get_start(); block = block->next_block())
+			{
+				block->m_epoch++;
+			}
+		}
+
 		inline void add_owned_section_overlaps(section_storage_type &section)
 		{
 			u32 end = section.get_section_range().end;
@@ -285,6 +305,7 @@ namespace rsx
 		inline u32 get_exists_count() const { return exists_count; }
 		inline u32 get_locked_count() const { return locked_count; }
 		inline u32 get_unreleased_count() const { return unreleased_count; }
+		inline u64 get_epoch() const { return m_epoch.load(); }
 
 		/**
 		 * Utilities
@@ -357,17 +378,17 @@ namespace rsx
 		 */
 		inline void on_section_protected(const section_storage_type &section)
 		{
-			(void)section; // silence unused warning without _AUDIT
 			AUDIT(section.is_locked());
 			locked_count++;
+			publish_section_change(section);
 		}
 
 		inline void on_section_unprotected(const section_storage_type &section)
 		{
-			(void)section; // silence unused warning without _AUDIT
 			AUDIT(!section.is_locked());
 			u32 prev_locked = locked_count--;
 			ensure(prev_locked > 0);
+			publish_section_change(section);
 		}
 
 		inline void on_section_range_valid(section_storage_type &section)
@@ -375,6 +396,7 @@ namespace rsx
 			AUDIT(section.valid_range());
 			AUDIT(range.overlaps(section.get_section_base()));
 			add_owned_section_overlaps(section);
+			publish_section_change(section);
 		}
 
 		inline void on_section_range_invalid(section_storage_type &section)
@@ -382,12 +404,13 @@ namespace rsx
 			AUDIT(section.valid_range());
 			AUDIT(range.overlaps(section.get_section_base()));
 			remove_owned_section_overlaps(section);
+			publish_section_change(section);
 		}
 
 		inline void on_section_resources_created(const section_storage_type &section)
 		{
-			(void)section; // silence unused warning without _AUDIT
 			AUDIT(section.exists());
+			publish_section_change(section);
 
 			u32 prev_exists = exists_count++;
 
@@ -399,8 +422,8 @@ namespace rsx
 
 		inline void on_section_resources_destroyed(const section_storage_type &section)
 		{
-			(void)section; // silence unused warning without _AUDIT
 			AUDIT(!section.exists());
+			publish_section_change(section);
 
 			u32 prev_exists = exists_count--;
 			ensure(prev_exists > 0);
@@ -411,15 +434,17 @@ namespace rsx
 			}
 		}
 
-		void on_section_released(const section_storage_type &/*section*/)
+		void on_section_released(const section_storage_type &section)
 		{
 			u32 prev_unreleased = unreleased_count--;
 			ensure(prev_unreleased > 0);
+			publish_section_change(section);
 		}
 
-		void on_section_unreleased(const section_storage_type &/*section*/)
+		void on_section_unreleased(const section_storage_type &section)
 		{
 			unreleased_count++;
+			publish_section_change(section);
 		}
 
 
@@ -533,6 +558,20 @@ namespace rsx
 			return *m_tex_cache;
 		}
 
+		// Combined epoch of all blocks overlapping the range. Block epochs only grow, so any change yields a different value.
+		u64 get_range_epoch(const address_range &range) const
+		{
+			AUDIT(range.valid());
+
+			u64 result = 0;
+			for (u32 index = range.start / block_size; index <= range.end / block_size; index++)
+			{
+				result += blocks[index].get_epoch();
+			}
+
+			return result;
+		}
+
 
 		/**
 		 * Blocks
@@ -20,4 +20,19 @@ namespace rsx
 			return get_system_time();
 		}
 	}
+
+	// Nanosecond variant for timing operations too short for uclock
+	static inline u64 nclock()
+	{
+		static const f64 s_tsc_ns_scale = utils::get_tsc_freq() ? 1'000'000'000. / utils::get_tsc_freq() : 0.;
+
+		if (s_tsc_ns_scale != 0.)
+		{
+			return static_cast<u64>(utils::get_tsc() * s_tsc_ns_scale);
+		}
+		else
+		{
+			return get_system_time() * 1000;
+		}
+	}
 }
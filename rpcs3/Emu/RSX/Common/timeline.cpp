@@ -0,0 +1,278 @@
+#include "stdafx.h"
+#include "timeline.h"
+
+#include "Utilities/mutex.h"
+#include "Utilities/Thread.h"
+
+namespace rsx::timeline
+{
+	atomic_t<bool> g_enabled = false;
+
+	namespace
+	{
+		struct event_record
+		{
+			u64 start;
+			u64 end;
+			u64 arg;
+			event_type type;
+		};
+
+		// Ring slot published seqlock-style: seq is 2 * (index + 1) once event #index is complete, odd while it is being written
+		struct event_slot
+		{
+			atomic_t<u64> seq = 0;
+			atomic_t<u64> start = 0;
+			atomic_t<u64> end = 0;
+			atomic_t<u64> arg = 0;
+			atomic_t<event_type> type{};
+		};
+
+		// Enough for several frames worth of draw calls of a busy RSX thread
+		constexpr u64 s_ring_capacity = 1 << 14;
+
+		// Buffers of exited threads are kept for dumping until this many have accumulated
+		constexpr usz s_max_retired_buffers = 64;
+
+		struct thread_buffer
+		{
+			std::string name;
+			u32 tid = 0;
+			atomic_t<bool> alive = true;
+
+			// Only written by the owning thread, the head is published after each write
+			std::unique_ptr<event_slot[]> events = std::make_unique<event_slot[]>(s_ring_capacity);
+			atomic_t<u64> head = 0;
+		};
+
+		shared_mutex s_registry_lock;
+		std::vector<std::shared_ptr<thread_buffer>> s_registry;
+		u32 s_next_tid = 1;
+
+		std::shared_ptr<thread_buffer> register_thread()
+		{
+			auto buffer = std::make_shared<thread_buffer>();
+			buffer->name = thread_ctrl::get_current() ? thread_ctrl::get_name() : std::string("Unknown");
+
+			std::lock_guard lock(s_registry_lock);
+			buffer->tid = s_next_tid++;
+
+			if (usz retired = std::count_if(s_registry.begin(), s_registry.end(), [](const auto& e) { return !e->alive; });
+				retired >= s_max_retired_buffers)
+			{
+				// Drop the oldest buffer of an exited thread
+				s_registry.erase(std::find_if(s_registry.begin(), s_registry.end(), [](const auto& e) { return !e->alive; }));
+			}
+
+			s_registry.push_back(buffer);
+			return buffer;
+		}
+
+		struct tls_buffer
+		{
+			std::shared_ptr<thread_buffer> buffer;
+
+			~tls_buffer()
+			{
+				if (buffer)
+				{
+					buffer->alive = false;
+				}
+			}
+		};
+
+		thread_local tls_buffer s_tls;
+
+		const char* get_event_name(event_type type)
+		{
+			switch (type)
+			{
+			case event_type::ppu_flip_request: return "PPU flip request";
+			case event_type::fifo_drain: return "FIFO drain";
+			case event_type::draw_batch: return "Draw";
+			case event_type::texture_cache_miss: return "Texture cache miss";
+			case event_type::shader_compile: return "Shader compile";
+			case event_type::dma_stall: return "DMA stall";
+			case event_type::flip: return "Flip";
+			case event_type::flatten_decision: return "FIFO flattening";
+			case event_type::draw_statistics: return "Draw calls";
+			case event_type::zcull_sync: return "ZCULL sync";
+			case event_type::count: break;
+			}
+
+			return "Unknown";
+		}
+
+		// Escapes a string for use in a JSON string literal
+		std::string json_escape(std::string_view str)
+		{
+			std::string result;
+			result.reserve(str.size());
+
+			for (const char c : str)
+			{
+				switch (c)
+				{
+				case '"': result += "\\\""; break;
+				case '\\': result += "\\\\"; break;
+				case '\n': result += "\\n"; break;
+				case '\r': result += "\\r"; break;
+				case '\t': result += "\\t"; break;
+				default:
+				{
+					if (static_cast<u8>(c) < 0x20)
+					{
+						fmt::append(result, "\\u%04x", static_cast<u8>(c));
+					}
+					else
+					{
+						result += c;
+					}
+
+					break;
+				}
+				}
+			}
+
+			return result;
+		}
+	}
+
+	void record(event_type type, u64 start, u64 end, u64 arg) noexcept
+	{
+		auto& buffer = s_tls.buffer;
+
+		if (!buffer) [[unlikely]]
+		{
+			buffer = register_thread();
+		}
+
+		const u64 head = buffer->head.observe();
+		event_slot& slot = buffer->events[head % s_ring_capacity];
+
+		// Readers which observe any of the new fields will also observe the odd sequence and drop the slot
+		slot.seq.release(head * 2 + 1);
+		atomic_fence_release();
+		slot.start.release(start);
+		slot.end.release(end);
+		slot.arg.release(arg);
+		slot.type.release(type);
+		slot.seq.release(head * 2 + 2);
+
+		buffer->head.release(head + 1);
+	}
+
+	bool dump(const std::string& path)
+	{
+		std::vector<std::shared_ptr<thread_buffer>> buffers;
+		{
+			reader_lock lock(s_registry_lock);
+			buffers = s_registry;
+		}
+
+		struct thread_events
+		{
+			const thread_buffer* owner;
+			std::vector<event_record> events;
+		};
+
+		std::vector<thread_events> snapshot;
+		u64 base_time = umax;
+
+		for (const auto& buffer : buffers)
+		{
+			const u64 head = buffer->head.load();
+			const u64 first = head > s_ring_capacity ? head - s_ring_capacity : 0;
+
+			thread_events entry{ buffer.get() };
+			entry.events.reserve(head - first);
+
+			for (u64 i = first; i < head; i++)
+			{
+				const event_slot& slot = buffer->events[i % s_ring_capacity];
+
+				// The owner keeps recording while the copy is made, skip slots it is rewriting or has already reused
+				const u64 seq = slot.seq.load();
+
+				if (seq != i * 2 + 2)
+				{
+					continue;
+				}
+
+				const event_record e{ slot.start.observe(), slot.end.observe(), slot.arg.observe(), slot.type.observe() };
+				atomic_fence_acquire();
+
+				if (slot.seq.observe() == seq)
+				{
+					entry.events.push_back(e);
+				}
+			}
+
+			for (const auto& e : entry.events)
+			{
+				base_time = std::min(base_time, e.start);
+			}
+
+			snapshot.push_back(std::move(entry));
+		}
+
+		fs::pending_file file(path);
+		if (!file.file)
+		{
+			rsx_log.error("Failed to create frame timeline %s (%s)", path, fs::g_tls_error);
+			return false;
+		}
+
+		std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+		usz event_count = 0;
+
+		for (const auto& entry : snapshot)
+		{
+			out += fmt::format("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n", entry.owner->tid, json_escape(entry.owner->name));
+
+			for (const auto& e : entry.events)
+			{
+				// Chrome trace timestamps are in microseconds
+				const f64 ts = (e.start - base_time) / 1000.;
+
+				if (e.type == event_type::draw_statistics)
+				{
+					out += fmt::format("{\"name\":\"%s\",\"cat\":\"rsx\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"submitted\":%u,\"merged\":%u}},\n",
+						get_event_name(e.type), ts, entry.owner->tid, static_cast<u32>(e.arg), static_cast<u32>(e.arg >> 32));
+				}
+				else if (e.type == event_type::ppu_flip_request || e.type == event_type::flatten_decision)
+				{
+					out += fmt::format("{\"name\":\"%s\",\"cat\":\"rsx\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%llu}},\n",
+						get_event_name(e.type), ts, entry.owner->tid, e.arg);
+				}
+				else
+				{
+					out += fmt::format("{\"name\":\"%s\",\"cat\":\"rsx\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%u,\"args\":{\"arg\":%llu}},\n",
+						get_event_name(e.type), ts, (e.end - e.start) / 1000., entry.owner->tid, e.arg);
+				}
+
+				event_count++;
+			}
+
+			// Flush in chunks to keep memory usage bounded on long captures
+			if (out.size() >= 0x100000)
+			{
+				file.file.write(out);
+				out.clear();
+			}
+		}
+
+		// Process metadata doubles as a terminator since trailing commas are not allowed
+		out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"RPCS3\"}}\n]}\n";
+		file.file.write(out);
+
+		if (!file.commit())
+		{
+			rsx_log.error("Failed to write frame timeline %s (%s)", path, fs::g_tls_error);
+			return false;
+		}
+
+		rsx_log.success("Frame timeline with %u events saved to %s", event_count, path);
+		return true;
+	}
+}
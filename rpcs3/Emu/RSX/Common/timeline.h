@@ -0,0 +1,78 @@
+#pragma once
+
+#include <util/types.hpp>
+#include <util/atomic.hpp>
+
+#include "time.hpp"
+
+#include <string>
+
+namespace rsx::timeline
+{
+	enum class event_type : u8
+	{
+		ppu_flip_request,   // Instant, arg = display buffer
+		fifo_drain,         // FIFO busy until it ran dry
+		draw_batch,         // begin/end scope, arg = number of subdraws
+		texture_cache_miss, // Texture uploaded from CPU memory, arg = address
+		shader_compile,     // Program decompilation or pipeline link, arg = program id
+		dma_stall,          // RSX waiting on offloaded transfers
+		flip,               // Frame presentation, arg = display buffer
+		flatten_decision,   // Instant, arg = FIFO::flattening_helper::decision
+		draw_statistics,    // Counter, arg = merged draws << 32 | submitted draws
+		zcull_sync,         // RSX waiting on occlusion query results
+
+		count
+	};
+
+	// Recording is enabled from the configuration when the RSX thread starts
+	extern atomic_t<bool> g_enabled;
+
+	static inline bool enabled()
+	{
+		return g_enabled.observe();
+	}
+
+	// Appends a completed event to the ring buffer of the calling thread, timestamps come from rsx::nclock()
+	void record(event_type type, u64 start, u64 end, u64 arg = 0) noexcept;
+
+	static inline void record_instant(event_type type, u64 arg = 0) noexcept
+	{
+		if (enabled())
+		{
+			const u64 now = rsx::nclock();
+			record(type, now, now, arg);
+		}
+	}
+
+	class scoped_event
+	{
+		u64 m_start = 0;
+		u64 m_arg;
+		event_type m_type;
+
+	public:
+		scoped_event(event_type type, u64 arg = 0) noexcept
+			: m_arg(arg), m_type(type)
+		{
+			if (enabled())
+			{
+				m_start = rsx::nclock();
+			}
+		}
+
+		scoped_event(const scoped_event&) = delete;
+		scoped_event& operator=(const scoped_event&) = delete;
+
+		~scoped_event()
+		{
+			if (m_start)
+			{
+				record(m_type, m_start, rsx::nclock(), m_arg);
+			}
+		}
+	};
+
+	// Writes the recorded events of all threads as Chrome trace-event JSON (viewable in Perfetto)
+	bool dump(const std::string& path);
+}
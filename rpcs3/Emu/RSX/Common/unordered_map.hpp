@@ -7,6 +7,9 @@ namespace rsx
 {
 	template<typename T, typename U>
 	using unordered_map = std::unordered_map<T, U>;
+
+	template<typename T, typename U, typename Hash, typename KeyEqual>
+	using unordered_node_map = std::unordered_map<T, U, Hash, KeyEqual>;
 }
 #else
 #include "3rdparty/robin_hood/include/robin_hood.h"
@@ -15,5 +18,9 @@ namespace rsx
 {
 	template<typename T, typename U>
 	using unordered_map = ::robin_hood::unordered_map<T, U>;
+
+	// Open addressing with stable references to keys and values
+	template<typename T, typename U, typename Hash, typename KeyEqual>
+	using unordered_node_map = ::robin_hood::unordered_node_map<T, U, Hash, KeyEqual>;
 }
 #endif
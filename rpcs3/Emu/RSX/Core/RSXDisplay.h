@@ -19,6 +19,25 @@ namespace rsx
 
 		u32 vertex_cache_request_count;
 		u32 vertex_cache_miss_count;
+
+		u32 program_lookup_count;
+		u64 program_lookup_time; // In nanoseconds
+
+		u32 program_analysis_count;
+		u32 program_analysis_hits;
+
+		u32 merged_draw_calls;    // Draws folded into the previous one by the FIFO flattener
+		u32 register_writes;      // Method register writes decoded from the FIFO
+		bool flattening_enabled;
+
+		u32 zcull_sync_count;
+		u64 zcull_stall_time;     // In microseconds
+		u32 zcull_report_count;
+		u32 zcull_write_count;
+
+		u64 frame_arena_used;     // Transient allocations served by the frame arena, in bytes
+		u64 frame_arena_peak;
+		u32 frame_arena_fallbacks;
 	};
 
 	struct frame_time_t
@@ -47,6 +47,7 @@ namespace rsx
 		std::array<atomic_t<u32>, 4096> ea;
 		std::array<atomic_t<u32>, 4096> io;
 		std::array<shared_mutex, 0x1'0000'0000 / c_lock_stride> rs;
+		atomic_t<u32> version = 0; // Incremented on every layout change
 
 		rsx_iomap_table() noexcept;
 
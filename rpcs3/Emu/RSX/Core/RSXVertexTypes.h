@@ -4,6 +4,7 @@
 #include "../Common/simple_array.hpp"
 #include "../gcm_enums.h"
 
+#include <optional>
 #include <span>
 
 namespace rsx
@@ -174,4 +175,15 @@ namespace rsx
 			return mem;
 		}
 	};
+
+	// Vertex range and index buffer of a subdraw, as written by thread::write_draw_index_data
+	struct draw_index_info
+	{
+		bool index_rebase;       // Vertices are read relative to min_index
+		u32 min_index;
+		u32 max_index;
+		u32 vertex_draw_count;
+		u32 vertex_index_offset;
+		std::optional<std::pair<index_array_type, u32>> index_info; // Index type and heap offset, empty when drawing without indices
+	};
 }
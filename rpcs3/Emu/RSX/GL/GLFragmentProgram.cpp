@@ -2,6 +2,9 @@
 #include "GLFragmentProgram.h"
 
 #include "Emu/system_config.h"
+#include "Emu/IdManager.h"
+#include "Emu/RSX/Common/time.hpp"
+#include "../Program/program_source_cache.h"
 #include "GLCommonDecompiler.h"
 #include "../GCM.h"
 #include "../Program/GLSLCommon.h"
@@ -334,32 +337,61 @@ GLFragmentProgram::~GLFragmentProgram()
 
 void GLFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 {
-	u32 size;
+	const auto& driver_caps = gl::get_driver_caps();
+
+	// Everything the decompiler output depends on besides the program itself
+	u64 options_hash = rpcs3::hash64(rpcs3::fnv_seed, "GLFP"_u32);
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(g_cfg.video.shader_precision.get()));
+	options_hash = rpcs3::hash64(options_hash, driver_caps.NV_gpu_shader5_supported);
+	options_hash = rpcs3::hash64(options_hash, driver_caps.AMD_gpu_shader_half_float_supported);
+	options_hash = rpcs3::hash64(options_hash, driver_caps.vendor_NVIDIA);
+
+	auto& source_cache = g_fxo->get<rsx::program_source_cache>();
+	const u64 cache_key = rsx::program_source_cache::get_key(prog, options_hash);
+	const u64 start = rsx::uclock();
+
 	std::string source;
-	GLFragmentDecompilerThread decompiler(source, parr, prog, size);
+	utils::serial ar;
 
-	if (g_cfg.video.shader_precision == gpu_preset_level::low)
+	if (source_cache.load(cache_key, ar))
 	{
-		const auto driver_caps = gl::get_driver_caps();
-		decompiler.device_props.has_native_half_support = driver_caps.NV_gpu_shader5_supported || driver_caps.AMD_gpu_shader_half_float_supported;
-		decompiler.device_props.has_low_precision_rounding = driver_caps.vendor_NVIDIA;
+		ar(source, FragmentConstantOffsetCache);
+		source_cache.on_restored(rsx::uclock() - start);
 	}
+	else
+	{
+		u32 size;
+		GLFragmentDecompilerThread decompiler(source, parr, prog, size);
 
-	decompiler.Task();
+		if (g_cfg.video.shader_precision == gpu_preset_level::low)
+		{
+			decompiler.device_props.has_native_half_support = driver_caps.NV_gpu_shader5_supported || driver_caps.AMD_gpu_shader_half_float_supported;
+			decompiler.device_props.has_low_precision_rounding = driver_caps.vendor_NVIDIA;
+		}
 
-	for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
-	{
-		for (const ParamItem& PI : PT.items)
+		decompiler.Task();
+
+		for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
 		{
-			if (PT.type == "sampler1D" ||
-				PT.type == "sampler2D" ||
-				PT.type == "sampler3D" ||
-				PT.type == "samplerCube")
-				continue;
+			for (const ParamItem& PI : PT.items)
+			{
+				if (PT.type == "sampler1D" ||
+					PT.type == "sampler2D" ||
+					PT.type == "sampler3D" ||
+					PT.type == "samplerCube")
+					continue;
+
+				usz offset = atoi(PI.name.c_str() + 2);
+				FragmentConstantOffsetCache.push_back(offset);
+			}
+		}
 
-			usz offset = atoi(PI.name.c_str() + 2);
-			FragmentConstantOffsetCache.push_back(offset);
+		if (source_cache.enabled())
+		{
+			ar(source, FragmentConstantOffsetCache);
 		}
+
+		source_cache.store(cache_key, ar, rsx::uclock() - start);
 	}
 
 	shader.create(::glsl::program_domain::glsl_fragment_program, source);
@@ -367,6 +367,11 @@ void GLGSRender::on_init_thread()
 		{
 			// Program was linked or queued for linking
 			m_shaders_cache->store(props, vp, fp);
+		},
+		[this](void* const& props, const RSXVertexProgram& vp, const RSXFragmentProgram& fp)
+		{
+			// Cached program was requested for the first time this session
+			m_shaders_cache->touch(props, vp, fp);
 		}
 	);
 
@@ -736,9 +741,17 @@ bool GLGSRender::load_program()
 	if (shadermode != shader_mode::interpreter_only) [[likely]]
 	{
 		void* pipeline_properties = nullptr;
+		const u64 lookup_start = m_profiler.enabled ? rsx::nclock() : 0;
+
 		std::tie(m_program, m_vertex_prog, m_fragment_prog) = m_prog_buffer.get_graphics_pipeline(current_vertex_program, current_fragment_program, pipeline_properties,
 			shadermode != shader_mode::recompiler, true);
 
+		if (m_profiler.enabled)
+		{
+			m_frame_stats.program_lookup_time += rsx::nclock() - lookup_start;
+			m_frame_stats.program_lookup_count++;
+		}
+
 		if (m_prog_buffer.check_cache_missed())
 		{
 			// Notify the user with HUD notification
@@ -809,13 +822,7 @@ void GLGSRender::load_program_env()
 	{
 		// Vertex state
 		auto mapping = m_vertex_env_buffer->alloc_from_heap(144, m_uniform_buffer_offset_align);
-		auto buf = static_cast<u8*>(mapping.first);
-		fill_scale_offset_data(buf, false);
-		fill_user_clip_data(buf + 64);
-		*(reinterpret_cast<u32*>(buf + 128)) = rsx::method_registers.transform_branch_bits();
-		*(reinterpret_cast<f32*>(buf + 132)) = rsx::method_registers.point_size() * rsx::get_resolution_scale();
-		*(reinterpret_cast<f32*>(buf + 136)) = rsx::method_registers.clip_min();
-		*(reinterpret_cast<f32*>(buf + 140)) = rsx::method_registers.clip_max();
+		fill_vertex_env_data(mapping.first);
 
 		m_vertex_env_buffer->bind_range(GL_VERTEX_PARAMS_BIND_SLOT, mapping.second, 144);
 	}
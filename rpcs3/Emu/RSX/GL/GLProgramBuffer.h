@@ -113,9 +113,10 @@ struct GLProgramBuffer : public program_state_cache<GLTraits>
 {
 	GLProgramBuffer() = default;
 
-	void initialize(decompiler_callback_t callback)
+	void initialize(decompiler_callback_t callback, decompiler_callback_t usage_callback = {})
 	{
 		notify_pipeline_compiled = callback;
+		notify_pipeline_used = usage_callback;
 	}
 
 	u64 get_hash(void* const&)
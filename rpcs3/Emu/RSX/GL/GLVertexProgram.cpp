@@ -3,6 +3,9 @@
 
 #include "Emu/System.h"
 #include "Emu/system_config.h"
+#include "Emu/IdManager.h"
+#include "Emu/RSX/Common/time.hpp"
+#include "../Program/program_source_cache.h"
 
 #include "GLCommonDecompiler.h"
 #include "../Program/GLSLCommon.h"
@@ -273,12 +276,43 @@ GLVertexProgram::~GLVertexProgram()
 
 void GLVertexProgram::Decompile(const RSXVertexProgram& prog)
 {
+	const auto& dev_caps = gl::get_driver_caps();
+
+	// Everything the decompiler output depends on besides the program itself
+	u64 options_hash = rpcs3::hash64(rpcs3::fnv_seed, "GLVP"_u32);
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(g_cfg.video.shader_precision.get()));
+	options_hash = rpcs3::hash64(options_hash, dev_caps.NV_depth_buffer_float_supported);
+	options_hash = rpcs3::hash64(options_hash, dev_caps.vendor_NVIDIA);
+	options_hash = rpcs3::hash64(options_hash, dev_caps.vendor_MESA);
+	options_hash = rpcs3::hash64(options_hash, dev_caps.vendor_INTEL);
+
+	auto& source_cache = g_fxo->get<rsx::program_source_cache>();
+	const u64 cache_key = rsx::program_source_cache::get_key(prog, options_hash);
+	const u64 start = rsx::uclock();
+
 	std::string source;
-	GLVertexDecompilerThread decompiler(prog, source, parr);
-	decompiler.Task();
+	utils::serial ar;
 
-	has_indexed_constants = decompiler.properties.has_indexed_constants;
-	constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+	if (source_cache.load(cache_key, ar))
+	{
+		ar(source, has_indexed_constants, constant_ids);
+		source_cache.on_restored(rsx::uclock() - start);
+	}
+	else
+	{
+		GLVertexDecompilerThread decompiler(prog, source, parr);
+		decompiler.Task();
+
+		has_indexed_constants = decompiler.properties.has_indexed_constants;
+		constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+
+		if (source_cache.enabled())
+		{
+			ar(source, has_indexed_constants, constant_ids);
+		}
+
+		source_cache.store(cache_key, ar, rsx::uclock() - start);
+	}
 
 	shader.create(::glsl::program_domain::glsl_vertex_program, source);
 	id = shader.id();
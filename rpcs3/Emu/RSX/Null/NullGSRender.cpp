@@ -1,17 +1,430 @@
 #include "stdafx.h"
 #include "NullGSRender.h"
 
+#include "Emu/Memory/vm.h"
+#include "Emu/RSX/Common/BufferUtils.h"
+#include "Emu/RSX/Common/time.hpp"
+#include "Emu/RSX/Program/program_state_cache2.hpp"
+#include "Emu/RSX/rsx_methods.h"
+#include "util/fnv_hash.hpp"
+
 u64 NullGSRender::get_cycles()
 {
 	return thread_ctrl::get_cycles(static_cast<named_thread<NullGSRender>&>(*this));
 }
 
-NullGSRender::NullGSRender(utils::serial* ar) noexcept : GSRender(ar)
+NullGSRender::NullGSRender(utils::serial* ar) noexcept
+	: GSRender(ar)
+	, m_frontend_emulation(g_cfg.video.null_renderer_frontend_emulation)
+{
+	if (m_frontend_emulation)
+	{
+		// Advertise the same capabilities as a desktop backend so that the front end takes the same paths
+		backend_config.supports_multidraw = true;
+		backend_config.supports_normalized_barycentrics = true;
+	}
+}
+
+void NullGSRender::on_init_thread()
+{
+	GSRender::on_init_thread();
+
+	if (m_frontend_emulation)
+	{
+		m_attrib_ring_buffer.create(128 * 0x100000, "attrib buffer");
+		m_index_ring_buffer.create(16 * 0x100000, "index buffer");
+		m_uniform_ring_buffer.create(16 * 0x100000, "uniform buffer");
+
+		rsx_log.notice("Null renderer is emulating the RSX front end");
+	}
+}
+
+void NullGSRender::on_exit()
+{
+	m_prog_buffer.clear();
+	m_decoded_textures.clear();
+
+	GSRender::on_exit();
+}
+
+void NullGSRender::flip(const rsx::display_flip_info_t& info)
+{
+	m_decoded_textures.clear();
+
+	GSRender::flip(info);
+}
+
+void NullGSRender::begin()
 {
+	rsx::thread::begin();
+
+	if (!m_frontend_emulation || skip_current_frame || cond_render_ctrl.disable_rendering())
+	{
+		return;
+	}
+
+	if (m_graphics_state & rsx::pipeline_state::invalidate_pipeline_bits)
+	{
+		// Shaders need to be reloaded.
+		m_program = nullptr;
+	}
 }
 
 void NullGSRender::end()
 {
-	execute_nop_draw();
+	if (!m_frontend_emulation || skip_current_frame || cond_render_ctrl.disable_rendering())
+	{
+		execute_nop_draw();
+		rsx::thread::end();
+		return;
+	}
+
+	m_profiler.start();
+
+	if (m_graphics_state & (rsx::pipeline_state::fragment_program_ucode_dirty | rsx::pipeline_state::vertex_program_ucode_dirty))
+	{
+		analyse_current_rsx_pipeline();
+	}
+
+	m_frame_stats.setup_time += m_profiler.duration();
+
+	// Active texture environment is used to decode shaders
+	load_texture_env();
+	m_frame_stats.textures_upload_time += m_profiler.duration();
+
+	load_program();
+	load_program_env();
+	m_frame_stats.setup_time += m_profiler.duration();
+
+	rsx::method_registers.current_draw_clause.begin();
+	u32 subdraw = 0u;
+	do
+	{
+		emit_geometry(subdraw++);
+	}
+	while (rsx::method_registers.current_draw_clause.next());
+
+	// Nothing is ever in flight, the heaps can be recycled as soon as the draw is recorded
+	m_uniform_ring_buffer.reset_allocation_stats();
+
+	m_frame_stats.setup_time += m_profiler.duration();
+
 	rsx::thread::end();
 }
+
+void NullGSRender::emit_geometry(u32 sub_index)
+{
+	m_profiler.start();
+
+	if (!update_vertex_layout(m_vertex_layout, sub_index))
+	{
+		return;
+	}
+
+	// Write index buffers and count verts
+	const auto result = write_draw_index_data(m_vertex_layout,
+		[this](u32 size) { return m_index_ring_buffer.alloc_from_heap(size, 256); },
+		is_primitive_native);
+
+	if (result.vertex_draw_count == 0)
+	{
+		// Malformed vertex setup; abort
+		return;
+	}
+
+	const u32 vertex_count = (result.max_index - result.min_index) + 1;
+	u32 vertex_base = result.min_index;
+	u32 index_base = 0;
+
+	if (result.index_rebase)
+	{
+		vertex_base = rsx::get_index_from_base(vertex_base, rsx::method_registers.vertex_data_base_index());
+		index_base = result.min_index;
+	}
+
+	// Do actual vertex upload
+	const auto required = calculate_memory_requirements(m_vertex_layout, vertex_base, vertex_count);
+	std::pair<void*, u32> persistent_mapping = {}, volatile_mapping = {};
+
+	if (required.first > 0)
+	{
+		persistent_mapping = m_attrib_ring_buffer.alloc_from_heap(required.first, 16);
+	}
+
+	if (required.second > 0)
+	{
+		volatile_mapping = m_attrib_ring_buffer.alloc_from_heap(required.second, 16);
+	}
+
+	write_vertex_data_to_memory(m_vertex_layout, vertex_base, vertex_count, persistent_mapping.first, volatile_mapping.first);
+
+	// Vertex layout state
+	const auto mapping = m_uniform_ring_buffer.alloc_from_heap(128 + 16, 256);
+	auto buf = static_cast<u32*>(mapping.first);
+
+	buf[0] = index_base;
+	buf[1] = result.vertex_index_offset;
+	buf += 4;
+
+	fill_vertex_layout_state(m_vertex_layout, vertex_base, vertex_count, reinterpret_cast<s32*>(buf), persistent_mapping.second, volatile_mapping.second);
+
+	m_attrib_ring_buffer.reset_allocation_stats();
+	m_index_ring_buffer.reset_allocation_stats();
+
+	m_frame_stats.vertex_upload_time += m_profiler.duration();
+}
+
+template <typename T>
+void NullGSRender::decode_texture(const T& tex, rsx::sampled_image_descriptor_base* descriptor)
+{
+	const u32 texaddr = rsx::get_address(tex.offset(), tex.location());
+	const u32 format = tex.format() & ~(CELL_GCM_TEXTURE_LN | CELL_GCM_TEXTURE_UN);
+	const bool is_swizzled = !(tex.format() & CELL_GCM_TEXTURE_LN);
+	const auto extended_dimension = tex.get_extended_texture_dimension();
+
+	descriptor->image_type = extended_dimension;
+	descriptor->format_class = rsx::classify_format(format);
+	descriptor->ref_address = texaddr;
+	descriptor->samples = 1;
+	descriptor->texcoord_xform.scale[0] = 1.f;
+	descriptor->texcoord_xform.scale[1] = 1.f;
+	descriptor->texcoord_xform.scale[2] = 1.f;
+	descriptor->texcoord_xform.bias[0] = 0.f;
+	descriptor->texcoord_xform.bias[1] = 0.f;
+	descriptor->texcoord_xform.bias[2] = 0.f;
+	descriptor->texcoord_xform.clamp = false;
+
+	if (tex.format() & CELL_GCM_TEXTURE_UN)
+	{
+		switch (extended_dimension)
+		{
+		case rsx::texture_dimension_extended::texture_dimension_3d:
+		case rsx::texture_dimension_extended::texture_dimension_cubemap:
+			descriptor->texcoord_xform.scale[2] /= tex.depth();
+			[[ fallthrough ]];
+		case rsx::texture_dimension_extended::texture_dimension_2d:
+			descriptor->texcoord_xform.scale[1] /= tex.height();
+			[[ fallthrough ]];
+		default:
+			descriptor->texcoord_xform.scale[0] /= tex.width();
+			break;
+		}
+	}
+
+	if (!tex.width() || !tex.height() || !tex.depth())
+	{
+		return;
+	}
+
+	const u32 texture_size = static_cast<u32>(rsx::get_texture_size(tex));
+	if (!vm::check_addr(texaddr, vm::page_readable, texture_size))
+	{
+		rsx_log.warning("Texture at 0x%x is not readable, skipping decode", texaddr);
+		return;
+	}
+
+	// Images bound again in the same frame are served from the decode done earlier, like a texture cache hit
+	u64 key = rpcs3::hash64(rpcs3::fnv_seed, texaddr);
+	key = rpcs3::hash64(key, tex.format());
+	key = rpcs3::hash64(key, (u64{tex.width()} << 32) | (u64{tex.height()} << 16) | tex.depth());
+	key = rpcs3::hash64(key, tex.get_exact_mipmap_count());
+
+	if (!m_decoded_textures.insert(key).second)
+	{
+		return;
+	}
+
+	// Everything is decoded on the host CPU
+	rsx::texture_uploader_capabilities caps
+	{
+		.supports_byteswap = false,
+		.supports_vtc_decoding = false,
+		.supports_hw_deswizzle = false,
+		.supports_zero_copy = false,
+		.alignment = 4
+	};
+
+	const u32 block_size = rsx::get_format_block_size_in_bytes(format);
+
+	for (const rsx::subresource_layout& layout : rsx::get_subresources_layout(tex))
+	{
+		const usz row_pitch = utils::align<usz>(std::max<usz>(layout.width_in_block * block_size, layout.width_in_texel * 4u), caps.alignment);
+		const usz image_linear_size = row_pitch * layout.height_in_block * layout.depth;
+
+		if (m_texture_decode_buffer.size() < image_linear_size)
+		{
+			m_texture_decode_buffer.resize(image_linear_size);
+		}
+
+		rsx::io_buffer io_buf(m_texture_decode_buffer.data(), image_linear_size);
+		rsx::upload_texture_subresource(io_buf, layout, format, is_swizzled, caps);
+	}
+}
+
+void NullGSRender::load_texture_env()
+{
+	for (u32 textures_ref = current_fp_metadata.referenced_textures_mask, i = 0; textures_ref; textures_ref >>= 1, ++i)
+	{
+		if (!(textures_ref & 1))
+			continue;
+
+		if (!fs_sampler_state[i])
+			fs_sampler_state[i] = std::make_unique<null::sampled_image_descriptor>();
+
+		auto sampler_state = static_cast<null::sampled_image_descriptor*>(fs_sampler_state[i].get());
+		const auto& tex = rsx::method_registers.fragment_textures[i];
+		const auto previous_format_class = sampler_state->format_class;
+
+		if (m_textures_dirty[i])
+		{
+			if (tex.enabled())
+			{
+				decode_texture(tex, sampler_state);
+
+				if (sampler_state->format_class != previous_format_class)
+				{
+					m_graphics_state |= rsx::fragment_program_state_dirty;
+				}
+			}
+			else
+			{
+				*sampler_state = {};
+			}
+
+			m_textures_dirty[i] = false;
+		}
+	}
+
+	for (u32 textures_ref = current_vp_metadata.referenced_textures_mask, i = 0; textures_ref; textures_ref >>= 1, ++i)
+	{
+		if (!(textures_ref & 1))
+			continue;
+
+		if (!vs_sampler_state[i])
+			vs_sampler_state[i] = std::make_unique<null::sampled_image_descriptor>();
+
+		auto sampler_state = static_cast<null::sampled_image_descriptor*>(vs_sampler_state[i].get());
+		const auto& tex = rsx::method_registers.vertex_textures[i];
+		const auto previous_format_class = sampler_state->format_class;
+
+		if (m_vertex_textures_dirty[i])
+		{
+			if (tex.enabled())
+			{
+				decode_texture(tex, sampler_state);
+
+				if (sampler_state->format_class != previous_format_class)
+				{
+					m_graphics_state |= rsx::vertex_program_state_dirty;
+				}
+			}
+			else
+			{
+				*sampler_state = {};
+			}
+
+			m_vertex_textures_dirty[i] = false;
+		}
+	}
+}
+
+void NullGSRender::load_program()
+{
+	if (m_graphics_state & rsx::pipeline_state::invalidate_pipeline_bits)
+	{
+		get_current_fragment_program(fs_sampler_state);
+		ensure(current_fragment_program.valid);
+
+		get_current_vertex_program(vs_sampler_state);
+	}
+	else if (m_program)
+	{
+		return;
+	}
+
+	void* pipeline_properties = nullptr;
+	const u64 lookup_start = m_profiler.enabled ? rsx::nclock() : 0;
+
+	std::tie(m_program, m_vertex_prog, m_fragment_prog) = m_prog_buffer.get_graphics_pipeline(current_vertex_program, current_fragment_program, pipeline_properties,
+		false, false);
+
+	if (m_profiler.enabled)
+	{
+		m_frame_stats.program_lookup_time += rsx::nclock() - lookup_start;
+		m_frame_stats.program_lookup_count++;
+	}
+
+	ensure(m_program);
+}
+
+void NullGSRender::load_program_env()
+{
+	const u32 fragment_constants_size = current_fp_metadata.program_constants_buffer_length;
+
+	const bool update_transform_constants = m_graphics_state & rsx::pipeline_state::transform_constants_dirty;
+	const bool update_fragment_constants = (m_graphics_state & rsx::pipeline_state::fragment_constants_dirty) && fragment_constants_size;
+	const bool update_vertex_env = m_graphics_state & rsx::pipeline_state::vertex_state_dirty;
+	const bool update_fragment_env = m_graphics_state & rsx::pipeline_state::fragment_state_dirty;
+	const bool update_fragment_texture_env = m_graphics_state & rsx::pipeline_state::fragment_texture_state_dirty;
+	const bool update_raster_env = rsx::method_registers.polygon_stipple_enabled() && (m_graphics_state & rsx::pipeline_state::polygon_stipple_pattern_dirty);
+
+	if (update_vertex_env)
+	{
+		// Vertex state
+		auto mapping = m_uniform_ring_buffer.alloc_from_heap(144, 256);
+		fill_vertex_env_data(mapping.first);
+	}
+
+	if (update_transform_constants)
+	{
+		// Vertex constants
+		const usz transform_constants_size = (!m_vertex_prog || m_vertex_prog->has_indexed_constants) ? 8192 : m_vertex_prog->constant_ids.size() * 16;
+		if (transform_constants_size)
+		{
+			auto mapping = m_uniform_ring_buffer.alloc_from_heap(static_cast<u32>(transform_constants_size), 256);
+
+			const auto constant_ids = (transform_constants_size == 8192)
+				? std::span<const u16>{}
+				: std::span<const u16>(m_vertex_prog->constant_ids);
+			fill_vertex_program_constants_data(mapping.first, constant_ids);
+		}
+	}
+
+	if (update_fragment_constants)
+	{
+		// Fragment constants
+		auto mapping = m_uniform_ring_buffer.alloc_from_heap(fragment_constants_size, 256);
+
+		m_prog_buffer.fill_fragment_constants_buffer({ static_cast<f32*>(mapping.first), fragment_constants_size },
+			*ensure(m_fragment_prog), current_fragment_program, true);
+	}
+
+	if (update_fragment_env)
+	{
+		// Fragment state
+		auto mapping = m_uniform_ring_buffer.alloc_from_heap(32, 256);
+		fill_fragment_state_buffer(mapping.first, current_fragment_program);
+	}
+
+	if (update_fragment_texture_env)
+	{
+		// Fragment texture parameters
+		auto mapping = m_uniform_ring_buffer.alloc_from_heap(768, 256);
+		current_fragment_program.texture_params.write_to(mapping.first, current_fp_metadata.referenced_textures_mask);
+	}
+
+	if (update_raster_env)
+	{
+		auto mapping = m_uniform_ring_buffer.alloc_from_heap(128, 256);
+		std::memcpy(mapping.first, rsx::method_registers.polygon_stipple_pattern(), 128);
+
+		m_graphics_state.clear(rsx::pipeline_state::polygon_stipple_pattern_dirty);
+	}
+
+	m_graphics_state.clear(
+		rsx::pipeline_state::fragment_state_dirty |
+		rsx::pipeline_state::vertex_state_dirty |
+		rsx::pipeline_state::transform_constants_dirty |
+		rsx::pipeline_state::fragment_constants_dirty |
+		rsx::pipeline_state::fragment_texture_state_dirty);
+}
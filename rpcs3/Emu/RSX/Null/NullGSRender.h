@@ -1,5 +1,40 @@
 #pragma once
 #include "Emu/RSX/GSRender.h"
+#include "Emu/RSX/Common/ring_buffer_helper.h"
+#include "Emu/RSX/Common/TextureUtils.h"
+#include "NullProgramBuffer.h"
+
+#include <unordered_set>
+
+namespace null
+{
+	// Host memory backed ring buffer, stands in for the mapped GPU heaps of the real backends
+	class host_ring_buffer : public data_heap
+	{
+		std::vector<u8> m_data;
+
+	public:
+		void create(usz size, const char* name)
+		{
+			init(size, name, 0);
+			m_data.resize(size);
+		}
+
+		std::pair<void*, u32> alloc_from_heap(u32 alloc_size, u16 alignment)
+		{
+			const usz offset = (alignment <= 16) ? alloc<16>(alloc_size) : alloc<256>(alloc_size);
+			return { m_data.data() + offset, static_cast<u32>(offset) };
+		}
+	};
+
+	struct sampled_image_descriptor : public rsx::sampled_image_descriptor_base
+	{
+		u32 encoded_component_map() const override
+		{
+			return 0;
+		}
+	};
+}
 
 class NullGSRender : public GSRender
 {
@@ -10,5 +45,39 @@ public:
 	NullGSRender() noexcept : NullGSRender(nullptr) {}
 
 private:
+	// Runs the shared front end (vertex and index upload, program decompilation, texture decoding) without a host GPU
+	const bool m_frontend_emulation;
+
+	NullProgramBuffer m_prog_buffer;
+	const NullPipeline* m_program = nullptr;
+	const NullVertexProgram* m_vertex_prog = nullptr;
+	const NullFragmentProgram* m_fragment_prog = nullptr;
+
+	rsx::vertex_input_layout m_vertex_layout = {};
+
+	null::host_ring_buffer m_attrib_ring_buffer;
+	null::host_ring_buffer m_index_ring_buffer;
+	null::host_ring_buffer m_uniform_ring_buffer;
+
+	std::array<std::unique_ptr<rsx::sampled_image_descriptor_base>, rsx::limits::fragment_textures_count> fs_sampler_state = {};
+	std::array<std::unique_ptr<rsx::sampled_image_descriptor_base>, rsx::limits::vertex_textures_count> vs_sampler_state = {};
+
+	// Textures decoded during the current frame, each image is only decoded once per frame
+	std::unordered_set<u64> m_decoded_textures;
+	std::vector<std::byte> m_texture_decode_buffer;
+
+	void on_init_thread() override;
+	void on_exit() override;
+	void flip(const rsx::display_flip_info_t& info) override;
+
+	void begin() override;
 	void end() override;
+	void emit_geometry(u32 sub_index) override;
+
+	template <typename T>
+	void decode_texture(const T& tex, rsx::sampled_image_descriptor_base* descriptor);
+
+	void load_texture_env();
+	void load_program();
+	void load_program_env();
 };
@@ -0,0 +1,190 @@
+#include "stdafx.h"
+#include "NullProgramBuffer.h"
+
+#include "../Program/GLSLCommon.h"
+
+std::string NullVertexDecompilerThread::getFloatTypeName(usz elementCount)
+{
+	return glsl::getFloatTypeNameImpl(elementCount);
+}
+
+std::string NullVertexDecompilerThread::getIntTypeName(usz /*elementCount*/)
+{
+	return "ivec4";
+}
+
+std::string NullVertexDecompilerThread::getFunction(FUNCTION f)
+{
+	return glsl::getFunctionImpl(f);
+}
+
+std::string NullVertexDecompilerThread::compareFunction(COMPARE f, const std::string& Op0, const std::string& Op1, bool scalar)
+{
+	return glsl::compareFunctionImpl(f, Op0, Op1, scalar);
+}
+
+void NullVertexDecompilerThread::insertHeader(std::stringstream& OS)
+{
+	OS << "#version 430\n";
+}
+
+void NullVertexDecompilerThread::insertInputs(std::stringstream& OS, const std::vector<ParamType>& inputs)
+{
+	for (const ParamType& PT : inputs)
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "in " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullVertexDecompilerThread::insertConstants(std::stringstream& OS, const std::vector<ParamType>& constants)
+{
+	for (const ParamType& PT : constants)
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "uniform " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullVertexDecompilerThread::insertOutputs(std::stringstream& OS, const std::vector<ParamType>& outputs)
+{
+	for (const ParamType& PT : outputs)
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "out " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullVertexDecompilerThread::insertMainStart(std::stringstream& OS)
+{
+	OS << "void main()\n";
+	OS << "{\n";
+}
+
+void NullVertexDecompilerThread::insertMainEnd(std::stringstream& OS)
+{
+	OS << "}\n";
+}
+
+void NullVertexDecompilerThread::Task()
+{
+	m_shader = Decompile();
+}
+
+std::string NullFragmentDecompilerThread::getFloatTypeName(usz elementCount)
+{
+	return glsl::getFloatTypeNameImpl(elementCount);
+}
+
+std::string NullFragmentDecompilerThread::getHalfTypeName(usz elementCount)
+{
+	return glsl::getHalfTypeNameImpl(elementCount);
+}
+
+std::string NullFragmentDecompilerThread::getFunction(FUNCTION f)
+{
+	return glsl::getFunctionImpl(f);
+}
+
+std::string NullFragmentDecompilerThread::compareFunction(COMPARE f, const std::string& Op0, const std::string& Op1)
+{
+	return glsl::compareFunctionImpl(f, Op0, Op1);
+}
+
+void NullFragmentDecompilerThread::insertHeader(std::stringstream& OS)
+{
+	OS << "#version 430\n";
+}
+
+void NullFragmentDecompilerThread::insertInputs(std::stringstream& OS)
+{
+	for (const ParamType& PT : m_parr.params[PF_PARAM_IN])
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "in " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullFragmentDecompilerThread::insertOutputs(std::stringstream& OS)
+{
+	for (const ParamType& PT : m_parr.params[PF_PARAM_OUT])
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "out " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullFragmentDecompilerThread::insertConstants(std::stringstream& OS)
+{
+	for (const ParamType& PT : m_parr.params[PF_PARAM_UNIFORM])
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			OS << "uniform " << PT.type << " " << PI.name << ";\n";
+		}
+	}
+}
+
+void NullFragmentDecompilerThread::insertGlobalFunctions(std::stringstream& /*OS*/)
+{
+}
+
+void NullFragmentDecompilerThread::insertMainStart(std::stringstream& OS)
+{
+	OS << "void main()\n";
+	OS << "{\n";
+}
+
+void NullFragmentDecompilerThread::insertMainEnd(std::stringstream& OS)
+{
+	OS << "}\n";
+}
+
+void NullFragmentDecompilerThread::Task()
+{
+	m_shader = Decompile();
+}
+
+void NullVertexProgram::Decompile(const RSXVertexProgram& prog, u32 program_id)
+{
+	NullVertexDecompilerThread decompiler(prog, source);
+	decompiler.Task();
+
+	has_indexed_constants = decompiler.properties.has_indexed_constants;
+	constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+	id = program_id;
+}
+
+void NullFragmentProgram::Decompile(const RSXFragmentProgram& prog, u32 program_id)
+{
+	u32 size;
+	NullFragmentDecompilerThread decompiler(source, prog, size);
+	decompiler.Task();
+
+	for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
+	{
+		for (const ParamItem& PI : PT.items)
+		{
+			if (PT.type == "sampler1D" ||
+				PT.type == "sampler2D" ||
+				PT.type == "sampler3D" ||
+				PT.type == "samplerCube")
+				continue;
+
+			usz offset = atoi(PI.name.c_str() + 2);
+			FragmentConstantOffsetCache.push_back(offset);
+		}
+	}
+
+	id = program_id;
+}
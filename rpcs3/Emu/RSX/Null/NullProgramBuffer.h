@@ -0,0 +1,134 @@
+#pragma once
+#include "../Program/VertexProgramDecompiler.h"
+#include "../Program/FragmentProgramDecompiler.h"
+#include "../Program/ProgramStateCache.h"
+
+// Shader programs for the null renderer. The ucode goes through the full decompiler
+// so that its CPU cost is accounted for, but the generated source is never compiled.
+
+struct NullVertexDecompilerThread : public VertexProgramDecompiler
+{
+	std::string& m_shader;
+
+protected:
+	std::string getFloatTypeName(usz elementCount) override;
+	std::string getIntTypeName(usz elementCount) override;
+	std::string getFunction(FUNCTION) override;
+	std::string compareFunction(COMPARE, const std::string&, const std::string&, bool scalar) override;
+
+	void insertHeader(std::stringstream& OS) override;
+	void insertInputs(std::stringstream& OS, const std::vector<ParamType>& inputs) override;
+	void insertConstants(std::stringstream& OS, const std::vector<ParamType>& constants) override;
+	void insertOutputs(std::stringstream& OS, const std::vector<ParamType>& outputs) override;
+	void insertMainStart(std::stringstream& OS) override;
+	void insertMainEnd(std::stringstream& OS) override;
+
+public:
+	NullVertexDecompilerThread(const RSXVertexProgram& prog, std::string& shader)
+		: VertexProgramDecompiler(prog)
+		, m_shader(shader)
+	{
+	}
+
+	void Task();
+};
+
+struct NullFragmentDecompilerThread : public FragmentProgramDecompiler
+{
+	std::string& m_shader;
+
+protected:
+	std::string getFloatTypeName(usz elementCount) override;
+	std::string getHalfTypeName(usz elementCount) override;
+	std::string getFunction(FUNCTION) override;
+	std::string compareFunction(COMPARE, const std::string&, const std::string&) override;
+
+	void insertHeader(std::stringstream& OS) override;
+	void insertInputs(std::stringstream& OS) override;
+	void insertOutputs(std::stringstream& OS) override;
+	void insertConstants(std::stringstream& OS) override;
+	void insertGlobalFunctions(std::stringstream& OS) override;
+	void insertMainStart(std::stringstream& OS) override;
+	void insertMainEnd(std::stringstream& OS) override;
+
+public:
+	NullFragmentDecompilerThread(std::string& shader, const RSXFragmentProgram& prog, u32& size)
+		: FragmentProgramDecompiler(prog, size)
+		, m_shader(shader)
+	{
+	}
+
+	void Task();
+};
+
+struct NullVertexProgram
+{
+	u32 id = 0;
+	std::string source;
+	std::vector<u16> constant_ids;
+	bool has_indexed_constants = false;
+
+	void Decompile(const RSXVertexProgram& prog, u32 program_id);
+};
+
+struct NullFragmentProgram
+{
+	u32 id = 0;
+	std::string source;
+	std::vector<usz> FragmentConstantOffsetCache;
+
+	void Decompile(const RSXFragmentProgram& prog, u32 program_id);
+};
+
+struct NullPipeline
+{
+	const NullVertexProgram* vp = nullptr;
+	const NullFragmentProgram* fp = nullptr;
+};
+
+struct NullTraits
+{
+	using vertex_program_type = NullVertexProgram;
+	using fragment_program_type = NullFragmentProgram;
+	using pipeline_type = NullPipeline;
+	using pipeline_storage_type = std::unique_ptr<NullPipeline>;
+	using pipeline_properties = void*;
+
+	static
+	void recompile_fragment_program(const RSXFragmentProgram& RSXFP, fragment_program_type& fragmentProgramData, usz ID)
+	{
+		// Zero is reserved for the null program of the cache
+		fragmentProgramData.Decompile(RSXFP, static_cast<u32>(ID) + 1);
+	}
+
+	static
+	void recompile_vertex_program(const RSXVertexProgram& RSXVP, vertex_program_type& vertexProgramData, usz ID)
+	{
+		vertexProgramData.Decompile(RSXVP, static_cast<u32>(ID) + 1);
+	}
+
+	static
+	void validate_pipeline_properties(const vertex_program_type&, const fragment_program_type&, pipeline_properties&)
+	{
+	}
+
+	static
+	pipeline_type* build_pipeline(
+		const vertex_program_type& vertexProgramData,
+		const fragment_program_type& fragmentProgramData,
+		const pipeline_properties&,
+		bool /*compile_async*/,
+		std::function<pipeline_type*(pipeline_storage_type&)> callback)
+	{
+		// Linking is free, the pipeline only remembers its stages
+		auto pipeline = std::make_unique<NullPipeline>();
+		pipeline->vp = &vertexProgramData;
+		pipeline->fp = &fragmentProgramData;
+		return callback(pipeline);
+	}
+};
+
+struct NullProgramBuffer : public program_state_cache<NullTraits>
+{
+	NullProgramBuffer() = default;
+};
@@ -322,9 +322,9 @@ vertex_program_utils::vertex_program_metadata vertex_program_utils::analyse_vert
 usz vertex_program_storage_hash::operator()(const RSXVertexProgram &program) const
 {
 	usz hash = vertex_program_utils::get_vertex_program_ucode_hash(program);
-	hash ^= program.output_mask;
-	hash ^= program.texture_state.texture_dimensions;
-	hash ^= program.texture_state.multisampled_textures;
+	hash = rpcs3::hash64(hash, program.output_mask);
+	hash = rpcs3::hash64(hash, program.texture_state.texture_dimensions);
+	hash = rpcs3::hash64(hash, program.texture_state.multisampled_textures);
 	return hash;
 }
 
@@ -520,13 +520,13 @@ usz fragment_program_utils::get_fragment_program_ucode_hash(const RSXFragmentPro
 usz fragment_program_storage_hash::operator()(const RSXFragmentProgram& program) const
 {
 	usz hash = fragment_program_utils::get_fragment_program_ucode_hash(program);
-	hash ^= program.ctrl;
-	hash ^= +program.two_sided_lighting;
-	hash ^= program.texture_state.texture_dimensions;
-	hash ^= program.texture_state.shadow_textures;
-	hash ^= program.texture_state.redirected_textures;
-	hash ^= program.texture_state.multisampled_textures;
-	hash ^= program.texcoord_control_mask;
+	hash = rpcs3::hash64(hash, program.ctrl);
+	hash = rpcs3::hash64(hash, +program.two_sided_lighting);
+	hash = rpcs3::hash64(hash, program.texture_state.texture_dimensions);
+	hash = rpcs3::hash64(hash, program.texture_state.shadow_textures);
+	hash = rpcs3::hash64(hash, program.texture_state.redirected_textures);
+	hash = rpcs3::hash64(hash, program.texture_state.multisampled_textures);
+	hash = rpcs3::hash64(hash, program.texcoord_control_mask);
 
 	return hash;
 }
@@ -561,3 +561,120 @@ bool fragment_program_compare::operator()(const RSXFragmentProgram& binary1, con
 			return true;
 	}
 }
+
+static u64 get_ucode_block_hash(const void* ptr, u32 instruction_count)
+{
+	// 64-bit Fowler/Noll/Vo FNV-1a hash code, same mixing as the program ucode hashes
+	usz hash = 0xCBF29CE484222325ULL;
+
+	for (u32 i = 0; i < instruction_count; i++)
+	{
+		const auto inst = v128::loadu(ptr, i);
+		hash ^= inst._u64[0];
+		hash += (hash << 1) + (hash << 4) + (hash << 5) + (hash << 7) + (hash << 8) + (hash << 40);
+		hash ^= inst._u64[1];
+		hash += (hash << 1) + (hash << 4) + (hash << 5) + (hash << 7) + (hash << 8) + (hash << 40);
+	}
+
+	return hash;
+}
+
+vertex_program_utils::vertex_program_metadata program_analysis_cache::analyse_vertex_program(const u32* data, u32 entry, RSXVertexProgram& dst_prog)
+{
+	if (g_cfg.video.debug_program_analyser)
+	{
+		// The analyser dumps its input on every run
+		return vertex_program_utils::analyse_vertex_program(data, entry, dst_prog);
+	}
+
+	const u64 use = ++m_use_counter;
+	vertex_entry* victim = &m_vertex_entries[0];
+
+	for (auto& e : m_vertex_entries)
+	{
+		// The analysis only reads instructions inside the range it reports, an unchanged range yields the same result
+		if (e.entry == entry && e.ucode_hash == get_ucode_block_hash(data + e.base_address * 4, ::size32(e.data) / 4))
+		{
+			e.last_use = use;
+			m_stats.vertex_hits++;
+
+			dst_prog.base_address = e.base_address;
+			dst_prog.entry = entry;
+			dst_prog.data = e.data;
+			dst_prog.instruction_mask = e.instruction_mask;
+			dst_prog.jump_table = e.jump_table;
+			return e.metadata;
+		}
+
+		if (e.last_use < victim->last_use)
+		{
+			victim = &e;
+		}
+	}
+
+	m_stats.vertex_misses++;
+
+	const auto result = vertex_program_utils::analyse_vertex_program(data, entry, dst_prog);
+
+	victim->entry = entry;
+	victim->base_address = dst_prog.base_address;
+	victim->metadata = result;
+	victim->data = dst_prog.data;
+	victim->instruction_mask = dst_prog.instruction_mask;
+	victim->jump_table = dst_prog.jump_table;
+	victim->ucode_hash = get_ucode_block_hash(data + dst_prog.base_address * 4, ::size32(dst_prog.data) / 4);
+	victim->last_use = use;
+	return result;
+}
+
+fragment_program_utils::fragment_program_metadata program_analysis_cache::analyse_fragment_program(const void* ptr, u32 address)
+{
+	const u64 use = ++m_use_counter;
+	fragment_entry* victim = &m_fragment_entries[0];
+
+	for (auto& e : m_fragment_entries)
+	{
+		// Everything the analysis reads lies within the leading padding and the ucode it reports
+		if (e.address == address &&
+			e.ucode_hash == get_ucode_block_hash(ptr, (e.metadata.program_start_offset + e.metadata.program_ucode_length) / 16))
+		{
+			e.last_use = use;
+			m_stats.fragment_hits++;
+			return e.metadata;
+		}
+
+		if (e.last_use < victim->last_use)
+		{
+			victim = &e;
+		}
+	}
+
+	m_stats.fragment_misses++;
+
+	const auto result = fragment_program_utils::analyse_fragment_program(ptr);
+
+	victim->address = address;
+	victim->metadata = result;
+	victim->ucode_hash = get_ucode_block_hash(ptr, (result.program_start_offset + result.program_ucode_length) / 16);
+	victim->last_use = use;
+	return result;
+}
+
+program_analysis_cache::statistics program_analysis_cache::take_statistics()
+{
+	m_total.vertex_hits += m_stats.vertex_hits;
+	m_total.vertex_misses += m_stats.vertex_misses;
+	m_total.fragment_hits += m_stats.fragment_hits;
+	m_total.fragment_misses += m_stats.fragment_misses;
+	return std::exchange(m_stats, {});
+}
+
+program_analysis_cache::statistics program_analysis_cache::get_total_statistics() const
+{
+	statistics result = m_total;
+	result.vertex_hits += m_stats.vertex_hits;
+	result.vertex_misses += m_stats.vertex_misses;
+	result.fragment_hits += m_stats.fragment_hits;
+	result.fragment_misses += m_stats.fragment_misses;
+	return result;
+}
@@ -2,6 +2,8 @@
 
 #include "RSXFragmentProgram.h"
 #include "RSXVertexProgram.h"
+#include "../Common/unordered_map.hpp"
+#include "../Common/timeline.h"
 
 #include "Utilities/mutex.h"
 #include "util/logs.hpp"
@@ -79,6 +81,70 @@ namespace program_hash_util
 	{
 		bool operator()(const RSXFragmentProgram &binary1, const RSXFragmentProgram &binary2) const;
 	};
+
+	/**
+	 * Memoizes the analysis of the last few programs seen, so that games switching between a handful of programs
+	 * do not walk the ucode again on every switch. An entry is reused when the ucode range it was built from hashes the same.
+	 * Not thread-safe, each thread analysing programs owns its own instance.
+	 */
+	class program_analysis_cache
+	{
+		static constexpr u32 max_entries = 16;
+
+		struct vertex_entry
+		{
+			u64 ucode_hash = 0;
+			u64 last_use = 0;
+			u32 entry = umax;
+			u32 base_address = 0;
+			vertex_program_utils::vertex_program_metadata metadata{};
+
+			// Analysed program, copied into the destination program on a hit
+			std::vector<u32> data;
+			std::bitset<rsx::max_vertex_program_instructions> instruction_mask;
+			std::set<u32> jump_table;
+		};
+
+		struct fragment_entry
+		{
+			u64 ucode_hash = 0;
+			u64 last_use = 0;
+			u32 address = umax;
+			fragment_program_utils::fragment_program_metadata metadata{};
+		};
+
+		std::array<vertex_entry, max_entries> m_vertex_entries{};
+		std::array<fragment_entry, max_entries> m_fragment_entries{};
+		u64 m_use_counter = 0;
+
+	public:
+		struct statistics
+		{
+			u64 vertex_hits = 0;
+			u64 vertex_misses = 0;
+			u64 fragment_hits = 0;
+			u64 fragment_misses = 0;
+
+			u64 hits() const { return vertex_hits + fragment_hits; }
+			u64 lookups() const { return vertex_hits + vertex_misses + fragment_hits + fragment_misses; }
+		};
+
+	private:
+		statistics m_stats{}; // Since the last call to take_statistics
+		statistics m_total{};
+
+	public:
+		// Same as vertex_program_utils::analyse_vertex_program
+		vertex_program_utils::vertex_program_metadata analyse_vertex_program(const u32* data, u32 entry, RSXVertexProgram& dst_prog);
+
+		// Same as fragment_program_utils::analyse_fragment_program, address identifies the ucode location
+		fragment_program_utils::fragment_program_metadata analyse_fragment_program(const void* ptr, u32 address);
+
+		// Returns the counters accumulated since the previous call and resets them
+		statistics take_statistics();
+
+		statistics get_total_statistics() const;
+	};
 }
 
 
@@ -106,8 +172,9 @@ class program_state_cache
 	using vertex_program_type = typename backend_traits::vertex_program_type;
 	using fragment_program_type = typename backend_traits::fragment_program_type;
 
-	using binary_to_vertex_program = std::unordered_map<RSXVertexProgram, vertex_program_type, program_hash_util::vertex_program_storage_hash, program_hash_util::vertex_program_compare> ;
-	using binary_to_fragment_program = std::unordered_map<RSXFragmentProgram, fragment_program_type, program_hash_util::fragment_program_storage_hash, program_hash_util::fragment_program_compare>;
+	// Node maps keep references stable, callers hold on to programs while other threads insert
+	using binary_to_vertex_program = rsx::unordered_node_map<RSXVertexProgram, vertex_program_type, program_hash_util::vertex_program_storage_hash, program_hash_util::vertex_program_compare>;
+	using binary_to_fragment_program = rsx::unordered_node_map<RSXFragmentProgram, fragment_program_type, program_hash_util::fragment_program_storage_hash, program_hash_util::fragment_program_compare>;
 
 	using pipeline_data_type = std::tuple<pipeline_type*, const vertex_program_type*, const fragment_program_type*>;
 
@@ -116,17 +183,26 @@ class program_state_cache
 		u32 vertex_program_id;
 		u32 fragment_program_id;
 		pipeline_properties properties;
+		usz hash;
+
+		pipeline_key(u32 vp_id, u32 fp_id, const pipeline_properties& props)
+			: vertex_program_id(vp_id)
+			, fragment_program_id(fp_id)
+			, properties(props)
+		{
+			// Order-dependent so that swapped program ids do not collide
+			// Computed once per lookup, the map probes and compares against the cached value
+			hash = rpcs3::hash64(rpcs3::fnv_seed, vp_id);
+			hash = rpcs3::hash64(hash, fp_id);
+			hash = rpcs3::hash64(hash, rpcs3::hash_struct<pipeline_properties>(props));
+		}
 	};
 
 	struct pipeline_key_hash
 	{
 		usz operator()(const pipeline_key &key) const
 		{
-			usz hashValue = 0;
-			hashValue ^= rpcs3::hash_base<unsigned>(key.vertex_program_id);
-			hashValue ^= rpcs3::hash_base<unsigned>(key.fragment_program_id);
-			hashValue ^= rpcs3::hash_struct<pipeline_properties>(key.properties);
-			return hashValue;
+			return key.hash;
 		}
 	};
 
@@ -134,10 +210,16 @@ class program_state_cache
 	{
 		bool operator()(const pipeline_key &key1, const pipeline_key &key2) const
 		{
-			return (key1.vertex_program_id == key2.vertex_program_id) && (key1.fragment_program_id == key2.fragment_program_id) && (key1.properties == key2.properties);
+			return (key1.hash == key2.hash) && (key1.vertex_program_id == key2.vertex_program_id) && (key1.fragment_program_id == key2.fragment_program_id) && (key1.properties == key2.properties);
 		}
 	};
 
+	struct pipeline_entry
+	{
+		pipeline_storage_type handle{};
+		atomic_t<bool> used = false; // Set once the pipeline has been requested by the game this session
+	};
+
 protected:
 	using decompiler_callback_t = std::function<void(const pipeline_properties&, const RSXVertexProgram&, const RSXFragmentProgram&)>;
 
@@ -151,14 +233,24 @@ protected:
 
 	binary_to_vertex_program m_vertex_shader_cache;
 	binary_to_fragment_program m_fragment_shader_cache;
-	std::unordered_map<pipeline_key, pipeline_storage_type, pipeline_key_hash, pipeline_key_compare> m_storage;
+	rsx::unordered_node_map<pipeline_key, pipeline_entry, pipeline_key_hash, pipeline_key_compare> m_storage;
 
 	decompiler_callback_t notify_pipeline_compiled;
+	decompiler_callback_t notify_pipeline_used;
 
 	vertex_program_type __null_vertex_program;
 	fragment_program_type __null_fragment_program;
 	pipeline_storage_type __null_pipeline_handle;
 
+	void on_pipeline_used(pipeline_entry& entry, const pipeline_properties& properties, const RSXVertexProgram& vp, const RSXFragmentProgram& fp)
+	{
+		// Only the first request per session is reported to keep the per-draw cost to a single load
+		if (!entry.used.load() && notify_pipeline_used && !entry.used.exchange(true)) [[unlikely]]
+		{
+			notify_pipeline_used(properties, vp, fp);
+		}
+	}
+
 	/// bool here to inform that the program was preexisting.
 	std::tuple<const vertex_program_type&, bool> search_vertex_program(const RSXVertexProgram& rsx_vp, bool force_load = true)
 	{
@@ -188,7 +280,9 @@ protected:
 
 		if (recompile)
 		{
-			backend_traits::recompile_vertex_program(rsx_vp, *new_shader, m_next_id++);
+			const usz id = m_next_id++;
+			rsx::timeline::scoped_event compile_event(rsx::timeline::event_type::shader_compile, id);
+			backend_traits::recompile_vertex_program(rsx_vp, *new_shader, id);
 		}
 
 		return std::forward_as_tuple(*new_shader, false);
@@ -225,7 +319,9 @@ protected:
 		if (recompile)
 		{
 			it->first.clone_data();
-			backend_traits::recompile_fragment_program(rsx_fp, *new_shader, m_next_id++);
+			const usz id = m_next_id++;
+			rsx::timeline::scoped_event compile_event(rsx::timeline::event_type::shader_compile, id);
+			backend_traits::recompile_fragment_program(rsx_fp, *new_shader, id);
 		}
 
 		return std::forward_as_tuple(*new_shader, false);
@@ -335,8 +431,14 @@ public:
 			reader_lock lock(m_pipeline_mutex);
 			if (const auto I = m_storage.find(key); I != m_storage.end())
 			{
-				m_cache_miss_flag = (I->second == __null_pipeline_handle);
-				return { I->second.get(), &vertex_program, &fragment_program };
+				m_cache_miss_flag = (I->second.handle == __null_pipeline_handle);
+
+				if (allow_notification)
+				{
+					on_pipeline_used(I->second, pipelineProperties, vertexShader, fragmentShader);
+				}
+
+				return { I->second.handle.get(), &vertex_program, &fragment_program };
 			}
 		}
 
@@ -346,12 +448,21 @@ public:
 			// Check if another submission completed in the mean time
 			if (const auto I = m_storage.find(key); I != m_storage.end())
 			{
-				m_cache_miss_flag = (I->second == __null_pipeline_handle);
-				return { I->second.get(), &vertex_program, &fragment_program };
+				m_cache_miss_flag = (I->second.handle == __null_pipeline_handle);
+
+				if (allow_notification)
+				{
+					on_pipeline_used(I->second, pipelineProperties, vertexShader, fragmentShader);
+				}
+
+				return { I->second.handle.get(), &vertex_program, &fragment_program };
 			}
 
 			// Insert a placeholder if the key still doesn't exist to avoid re-linking of the same pipeline
-			m_storage[key] = std::move(__null_pipeline_handle);
+			// Pipelines built on behalf of the game are reported through the compilation notification instead
+			auto& entry = m_storage[key];
+			entry.handle = std::move(__null_pipeline_handle);
+			entry.used = allow_notification;
 		}
 
 		rsx_log.notice("Add program (vp id = %d, fp id = %d)", vertex_program.id, fragment_program.id);
@@ -372,7 +483,7 @@ public:
 				notify_pipeline_compiled(key.properties, vertexShader, fragmentShader_);
 
 				std::lock_guard lock(m_pipeline_mutex);
-				auto& pipe_result = m_storage[key];
+				auto& pipe_result = m_storage[key].handle;
 				pipe_result = std::move(pipeline);
 				return pipe_result.get();
 			};
@@ -387,12 +498,13 @@ public:
 				}
 
 				std::lock_guard lock(m_pipeline_mutex);
-				auto& pipe_result = m_storage[key];
+				auto& pipe_result = m_storage[key].handle;
 				pipe_result = std::move(pipeline);
 				return pipe_result.get();
 			};
 		}
 
+		rsx::timeline::scoped_event compile_event(rsx::timeline::event_type::shader_compile);
 		auto result = backend_traits::build_pipeline(
 			vertex_program,                 // VS, must already be decompiled and recompiled above
 			fragment_program,               // FS, must already be decompiled and recompiled above
@@ -411,6 +523,7 @@ public:
 		std::scoped_lock lock(m_vertex_mutex, m_fragment_mutex, m_decompiler_mutex, m_pipeline_mutex);
 
 		notify_pipeline_compiled = {};
+		notify_pipeline_used = {};
 		m_fragment_shader_cache.clear();
 		m_vertex_shader_cache.clear();
 		m_storage.clear();
@@ -0,0 +1,490 @@
+#include "stdafx.h"
+#include "pipeline_cache_file.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace rsx
+{
+	static u64 make_pack_id()
+	{
+		return static_cast<u64>(std::chrono::system_clock::now().time_since_epoch().count()) | 1;
+	}
+
+	pipeline_cache_file::~pipeline_cache_file()
+	{
+		close();
+	}
+
+	bool pipeline_cache_file::open(const std::string& path, u32 record_size)
+	{
+		std::lock_guard lock(m_lock);
+
+		m_path = path;
+		m_record_size = record_size;
+		m_entries.clear();
+		m_lookup.clear();
+
+		const std::string pack_path = path + ".pack";
+
+		if (!m_pack.open(pack_path, fs::read + fs::write + fs::create))
+		{
+			rsx_log.error("Failed to open pipeline cache %s (%s)", pack_path, fs::g_tls_error);
+			return false;
+		}
+
+		pack_header header{};
+		const u64 file_size = m_pack.size();
+
+		if (file_size >= sizeof(pack_header) && m_pack.read_at(0, &header, sizeof(header)) == sizeof(header) &&
+			(header.magic != s_pack_magic || header.version != s_pack_version || header.record_size != record_size))
+		{
+			rsx_log.error("Resetting pipeline cache %s since it's not binary compatible with the current shader cache", pack_path);
+			header = {};
+		}
+
+		if (header.magic != s_pack_magic)
+		{
+			header.magic = s_pack_magic;
+			header.version = s_pack_version;
+			header.record_size = record_size;
+			header.reserved = 0;
+			header.pack_id = make_pack_id();
+
+			m_pack.trunc(0);
+			m_pack.seek(0);
+
+			if (m_pack.write(&header, sizeof(header)) != sizeof(header))
+			{
+				rsx_log.error("Failed to initialize pipeline cache %s (%s)", pack_path, fs::g_tls_error);
+				m_pack.close();
+				return false;
+			}
+		}
+
+		m_pack_id = header.pack_id;
+
+		// Drop a partially written trailing record, the process could have been terminated mid-append
+		const u64 record_stride = sizeof(u64) + record_size;
+		m_pack_size = sizeof(pack_header) + (m_pack.size() - sizeof(pack_header)) / record_stride * record_stride;
+
+		if (m_pack_size != m_pack.size())
+		{
+			m_pack.trunc(m_pack_size);
+		}
+
+		u32 session = 0;
+		if (!load_index(session))
+		{
+			m_entries.clear();
+			m_lookup.clear();
+			session = 0;
+			scan_pack(sizeof(pack_header));
+		}
+
+		m_session = session + 1;
+		m_session_start = std::chrono::steady_clock::now();
+		m_dirty = true;
+		return true;
+	}
+
+	void pipeline_cache_file::start_session_clock()
+	{
+		std::lock_guard lock(m_lock);
+		m_session_start = std::chrono::steady_clock::now();
+	}
+
+	u32 pipeline_cache_file::get_session_time() const
+	{
+		const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - m_session_start).count();
+		return static_cast<u32>(std::min<s64>(elapsed, u32{umax} - 1));
+	}
+
+	bool pipeline_cache_file::load_index(u32& session)
+	{
+		fs::file index(m_path + ".index");
+		if (!index)
+		{
+			return false;
+		}
+
+		index_header header{};
+		if (!index.read(header) || header.magic != s_index_magic || (header.version != s_index_version && header.version != 1) ||
+			header.pack_id != m_pack_id || header.pack_size > m_pack_size)
+		{
+			rsx_log.warning("Pipeline cache index %s.index is stale, usage statistics will be reset", m_path);
+			return false;
+		}
+
+		if (header.version == 1)
+		{
+			std::vector<index_entry_v1> old_entries(header.entry_count);
+			if (!index.read(old_entries))
+			{
+				return false;
+			}
+
+			m_entries.clear();
+			m_entries.reserve(old_entries.size());
+
+			for (const auto& e : old_entries)
+			{
+				m_entries.push_back({ e.key, e.offset, e.use_count, e.last_session, umax, 0 });
+			}
+		}
+		else
+		{
+			m_entries.resize(header.entry_count);
+			if (!index.read(m_entries))
+			{
+				return false;
+			}
+		}
+
+		const u64 record_stride = sizeof(u64) + m_record_size;
+
+		for (usz i = 0; i < m_entries.size(); i++)
+		{
+			const auto& entry = m_entries[i];
+
+			if (entry.offset < sizeof(pack_header) + sizeof(u64) || entry.offset + m_record_size > header.pack_size ||
+				(entry.offset - sizeof(pack_header) - sizeof(u64)) % record_stride)
+			{
+				return false;
+			}
+
+			m_lookup.emplace(entry.key, i);
+		}
+
+		// Pick up records appended after the index was last written
+		scan_pack(header.pack_size);
+
+		session = header.session;
+		return true;
+	}
+
+	void pipeline_cache_file::scan_pack(u64 from)
+	{
+		const u64 record_stride = sizeof(u64) + m_record_size;
+
+		for (u64 offset = from; offset + record_stride <= m_pack_size; offset += record_stride)
+		{
+			u64 key = 0;
+			if (m_pack.read_at(offset, &key, sizeof(key)) != sizeof(key))
+			{
+				break;
+			}
+
+			if (m_lookup.emplace(key, m_entries.size()).second)
+			{
+				m_entries.push_back({ key, offset + sizeof(u64), 0, 0, umax, 0 });
+			}
+		}
+	}
+
+	void pipeline_cache_file::flush()
+	{
+		std::lock_guard lock(m_lock);
+
+		if (!m_pack || !m_dirty)
+		{
+			return;
+		}
+
+		index_header header{};
+		header.magic = s_index_magic;
+		header.version = s_index_version;
+		header.pack_id = m_pack_id;
+		header.pack_size = m_pack_size;
+		header.session = m_session;
+		header.entry_count = ::size32(m_entries);
+
+		const std::string index_path = m_path + ".index";
+
+		fs::pending_file temp(index_path);
+		if (!temp.file)
+		{
+			rsx_log.error("Failed to create pipeline cache index %s (%s)", index_path, fs::g_tls_error);
+			return;
+		}
+
+		temp.file.write(header);
+		temp.file.write(m_entries);
+
+		if (!temp.commit())
+		{
+			rsx_log.error("Failed to commit pipeline cache index %s (%s)", index_path, fs::g_tls_error);
+			return;
+		}
+
+		m_dirty = false;
+	}
+
+	void pipeline_cache_file::close()
+	{
+		flush();
+
+		std::lock_guard lock(m_lock);
+		m_pack.close();
+		m_entries.clear();
+		m_lookup.clear();
+	}
+
+	std::vector<pipeline_cache_file::index_entry> pipeline_cache_file::get_entries_by_hotness() const
+	{
+		std::vector<index_entry> result;
+		{
+			reader_lock lock(m_lock);
+			result = m_entries;
+		}
+
+		// Entries used recently come first, ties are broken by how many sessions used them
+		std::stable_sort(result.begin(), result.end(), [](const index_entry& a, const index_entry& b)
+		{
+			if (a.last_session != b.last_session)
+			{
+				return a.last_session > b.last_session;
+			}
+
+			return a.use_count > b.use_count;
+		});
+
+		return result;
+	}
+
+	bool pipeline_cache_file::read(const index_entry& entry, void* data) const
+	{
+		// Records are never rewritten in place, so reading does not need to synchronize with appends
+		return m_pack.read_at(entry.offset, data, m_record_size) == m_record_size;
+	}
+
+	bool pipeline_cache_file::append(u64 key, const void* data)
+	{
+		std::lock_guard lock(m_lock);
+
+		if (!m_pack || m_lookup.contains(key))
+		{
+			return false;
+		}
+
+		m_pack.seek(m_pack_size);
+
+		if (m_pack.write(&key, sizeof(key)) != sizeof(key) || m_pack.write(data, m_record_size) != m_record_size)
+		{
+			rsx_log.error("Failed to append to pipeline cache %s.pack (%s)", m_path, fs::g_tls_error);
+			m_pack.trunc(m_pack_size);
+			return false;
+		}
+
+		m_lookup.emplace(key, m_entries.size());
+		m_entries.push_back({ key, m_pack_size + sizeof(u64), 1, m_session, get_session_time(), 0 });
+		m_pack_size += sizeof(u64) + m_record_size;
+		m_dirty = true;
+		return true;
+	}
+
+	void pipeline_cache_file::touch(u64 key)
+	{
+		std::lock_guard lock(m_lock);
+
+		if (const auto found = m_lookup.find(key); found != m_lookup.end())
+		{
+			auto& entry = m_entries[found->second];
+
+			if (entry.last_session != m_session)
+			{
+				entry.last_session = m_session;
+				entry.first_use = get_session_time();
+				entry.use_count++;
+				m_dirty = true;
+			}
+		}
+	}
+
+	bool pipeline_cache_file::compact(const std::string& path, u32 max_idle_sessions, u32& kept, u32& pruned)
+	{
+		kept = 0;
+		pruned = 0;
+
+		const std::string pack_path = path + ".pack";
+		const std::string index_path = path + ".index";
+
+		fs::file pack(pack_path);
+		fs::file index(index_path);
+
+		pack_header pheader{};
+		index_header iheader{};
+
+		if (!pack || !pack.read(pheader) || pheader.magic != s_pack_magic || pheader.version != s_pack_version)
+		{
+			rsx_log.error("Pipeline cache compaction: %s is not a valid pipeline cache", pack_path);
+			return false;
+		}
+
+		if (!index || !index.read(iheader) || iheader.magic != s_index_magic || (iheader.version != s_index_version && iheader.version != 1) || iheader.pack_id != pheader.pack_id)
+		{
+			rsx_log.error("Pipeline cache compaction: %s has no usage statistics, boot it at least once first", pack_path);
+			return false;
+		}
+
+		std::vector<index_entry> entries;
+
+		if (iheader.version == 1)
+		{
+			std::vector<index_entry_v1> old_entries(iheader.entry_count);
+
+			if (index.read(old_entries))
+			{
+				entries.reserve(old_entries.size());
+
+				for (const auto& e : old_entries)
+				{
+					entries.push_back({ e.key, e.offset, e.use_count, e.last_session, umax, 0 });
+				}
+			}
+		}
+		else
+		{
+			entries.resize(iheader.entry_count);
+
+			if (!index.read(entries))
+			{
+				entries.clear();
+			}
+		}
+
+		if (entries.size() != iheader.entry_count)
+		{
+			rsx_log.error("Pipeline cache compaction: Failed to read %s", index_path);
+			return false;
+		}
+
+		index.close();
+
+		// Version 1 indexes are upgraded by the rewrite below
+		iheader.version = s_index_version;
+
+		pack_header new_header = pheader;
+		new_header.pack_id = make_pack_id();
+
+		fs::pending_file new_pack(pack_path);
+		if (!new_pack.file)
+		{
+			rsx_log.error("Pipeline cache compaction: Failed to create %s (%s)", pack_path, fs::g_tls_error);
+			return false;
+		}
+
+		new_pack.file.write(new_header);
+
+		std::vector<index_entry> new_entries;
+		std::vector<u8> record(sizeof(u64) + pheader.record_size);
+		u64 new_pack_size = sizeof(pack_header);
+
+		for (const auto& entry : entries)
+		{
+			if (iheader.session - entry.last_session >= max_idle_sessions)
+			{
+				pruned++;
+				continue;
+			}
+
+			if (pack.read_at(entry.offset - sizeof(u64), record.data(), record.size()) != record.size())
+			{
+				rsx_log.error("Pipeline cache compaction: Failed to read entry 0x%llx from %s", entry.key, pack_path);
+				return false;
+			}
+
+			new_pack.file.write(record);
+			new_entries.push_back({ entry.key, new_pack_size + sizeof(u64), entry.use_count, entry.last_session, entry.first_use, 0 });
+			new_pack_size += record.size();
+			kept++;
+		}
+
+		// Records appended after the index was last written have not had the chance to be used yet
+		const u64 record_stride = record.size();
+		for (u64 offset = iheader.pack_size; offset + record_stride <= pack.size(); offset += record_stride)
+		{
+			if (pack.read_at(offset, record.data(), record.size()) != record.size())
+			{
+				break;
+			}
+
+			u64 key = 0;
+			std::memcpy(&key, record.data(), sizeof(key));
+
+			new_pack.file.write(record);
+			new_entries.push_back({ key, new_pack_size + sizeof(u64), 0, iheader.session, umax, 0 });
+			new_pack_size += record.size();
+			kept++;
+		}
+
+		pack.close();
+
+		iheader.pack_id = new_header.pack_id;
+		iheader.pack_size = new_pack_size;
+		iheader.entry_count = ::size32(new_entries);
+
+		fs::pending_file new_index(index_path);
+		if (!new_index.file)
+		{
+			rsx_log.error("Pipeline cache compaction: Failed to create %s (%s)", index_path, fs::g_tls_error);
+			return false;
+		}
+
+		new_index.file.write(iheader);
+		new_index.file.write(new_entries);
+
+		// If the index fails to commit after the pack, the mismatching pack id resets statistics on next boot
+		if (!new_pack.commit() || !new_index.commit())
+		{
+			rsx_log.error("Pipeline cache compaction: Failed to commit %s (%s)", pack_path, fs::g_tls_error);
+			return false;
+		}
+
+		return true;
+	}
+
+	std::vector<std::string> pipeline_cache_file::find(const std::string& path)
+	{
+		std::vector<std::string> result;
+
+		if (path.ends_with(".pack"))
+		{
+			result.push_back(path.substr(0, path.size() - 5));
+			return result;
+		}
+
+		std::vector<std::string> directories{path};
+
+		while (!directories.empty())
+		{
+			const std::string dir = std::move(directories.back());
+			directories.pop_back();
+
+			for (auto&& entry : fs::dir(dir))
+			{
+				if (entry.name == "." || entry.name == "..")
+				{
+					continue;
+				}
+
+				if (entry.is_directory)
+				{
+					directories.push_back(dir + "/" + entry.name);
+				}
+				else if (entry.name.ends_with(".pack"))
+				{
+					// Other caches (such as the shader source cache) use packs as well, only pick up pipeline packs
+					u32 magic = 0;
+
+					if (fs::file pack(dir + "/" + entry.name); pack && pack.read(magic) && magic == s_pack_magic)
+					{
+						result.push_back(dir + "/" + entry.name.substr(0, entry.name.size() - 5));
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+}
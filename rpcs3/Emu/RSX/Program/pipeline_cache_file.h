@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace rsx
+{
+	/**
+	 * Packed, append-only storage for pipeline cache entries.
+	 * <name>.pack holds fixed-size records (a 64-bit key followed by an opaque blob) and is only ever appended to.
+	 * <name>.index maps keys to records and carries per-entry usage statistics across sessions.
+	 * A missing or stale index is rebuilt from the pack, losing only the statistics.
+	 */
+	class pipeline_cache_file
+	{
+	public:
+		struct index_entry
+		{
+			u64 key;
+			u64 offset;       // Byte offset of the record blob inside the pack
+			u32 use_count;    // Number of sessions this entry was used in
+			u32 last_session; // Most recent session this entry was used in
+			u32 first_use;    // Milliseconds into the last session until the entry was first used, umax if unknown
+			u32 reserved;
+		};
+
+	private:
+		struct pack_header
+		{
+			u32 magic;
+			u32 version;
+			u32 record_size;
+			u32 reserved;
+			u64 pack_id;
+		};
+
+		struct index_header
+		{
+			u32 magic;
+			u32 version;
+			u64 pack_id;
+			u64 pack_size;
+			u32 session;
+			u32 entry_count;
+		};
+
+		static constexpr u32 s_pack_magic = "RSPK"_u32;
+		static constexpr u32 s_index_magic = "RSPI"_u32;
+		static constexpr u32 s_pack_version = 1;
+		static constexpr u32 s_index_version = 2;
+
+		// Index entries written by version 1, without first use timestamps
+		struct index_entry_v1
+		{
+			u64 key;
+			u64 offset;
+			u32 use_count;
+			u32 last_session;
+		};
+
+		mutable shared_mutex m_lock;
+		fs::file m_pack;
+		std::string m_path;
+		std::vector<index_entry> m_entries;
+		std::unordered_map<u64, usz> m_lookup;
+		u64 m_pack_id = 0;
+		u64 m_pack_size = 0;
+		u32 m_record_size = 0;
+		u32 m_session = 0;
+		bool m_dirty = false;
+		std::chrono::steady_clock::time_point m_session_start{};
+
+		bool load_index(u32& session);
+		void scan_pack(u64 from);
+		u32 get_session_time() const;
+
+	public:
+		pipeline_cache_file() = default;
+		~pipeline_cache_file();
+
+		pipeline_cache_file(const pipeline_cache_file&) = delete;
+		pipeline_cache_file& operator=(const pipeline_cache_file&) = delete;
+
+		// Opens or creates <path>.pack and starts a new usage session
+		bool open(const std::string& path, u32 record_size);
+
+		// Writes the index with the current usage statistics
+		void flush();
+
+		void close();
+
+		explicit operator bool() const { return !!m_pack; }
+
+		// Current usage session, entries with last_session one below it were used by the previous session
+		u32 get_session() const { return m_session; }
+
+		// Restarts the clock used for first use timestamps, called once the game starts running
+		void start_session_clock();
+
+		// Returns all entries, most frequently and recently used first
+		std::vector<index_entry> get_entries_by_hotness() const;
+
+		// Reads the record blob of an entry, thread-safe
+		bool read(const index_entry& entry, void* data) const;
+
+		// Appends a new record, returns false if the key already exists
+		bool append(u64 key, const void* data);
+
+		// Marks an entry as used in the current session
+		void touch(u64 key);
+
+		// Rewrites the pack without entries that were not used in the last max_idle_sessions sessions
+		static bool compact(const std::string& path, u32 max_idle_sessions, u32& kept, u32& pruned);
+
+		// Returns the paths of all packed caches at or below path, without extension
+		static std::vector<std::string> find(const std::string& path);
+	};
+}
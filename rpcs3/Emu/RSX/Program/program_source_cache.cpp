@@ -0,0 +1,352 @@
+#include "stdafx.h"
+#include "program_source_cache.h"
+#include "ProgramStateCache.h"
+
+#include "Emu/RSX/Common/time.hpp"
+#include "rpcs3_version.h"
+
+#include "util/fnv_hash.hpp"
+
+#include <chrono>
+
+namespace rsx
+{
+	static u64 hash_payload(const u8* data, usz size)
+	{
+		usz hash = rpcs3::fnv_seed;
+		for (usz i = 0; i < size; i++)
+		{
+			hash = rpcs3::hash64(hash, data[i]);
+		}
+		return hash;
+	}
+
+	program_source_cache::~program_source_cache()
+	{
+		std::lock_guard lock(m_lock);
+		flush_index();
+	}
+
+	void program_source_cache::open(const std::string& path)
+	{
+		std::lock_guard lock(m_lock);
+
+		flush_index();
+
+		m_pack.close();
+		m_entries.clear();
+		m_path = path;
+		m_pack_size = 0;
+		m_enabled = false;
+		m_dirty = false;
+		m_hits = 0;
+		m_misses = 0;
+		m_restore_time = 0;
+		m_decompile_time = 0;
+
+		// Decompiler output is only valid for the build that produced it
+		const std::string build = rpcs3::get_verbose_version();
+		m_build_hash = rpcs3::fnv_seed;
+		for (const char c : build)
+		{
+			m_build_hash = rpcs3::hash64(m_build_hash, static_cast<u8>(c));
+		}
+
+		const std::string pack_path = m_path + ".pack";
+
+		if (!m_pack.open(pack_path, fs::read + fs::write + fs::create))
+		{
+			rsx_log.error("Shader source cache: Failed to open %s (%s)", pack_path, fs::g_tls_error);
+			return;
+		}
+
+		pack_header header{};
+
+		if (m_pack.size() < sizeof(header) || m_pack.read_at(0, &header, sizeof(header)) != sizeof(header) ||
+			header.magic != s_pack_magic || header.version != s_version || header.build_hash != m_build_hash)
+		{
+			if (m_pack.size())
+			{
+				rsx_log.notice("Shader source cache: Resetting %s since it was created by a different build", pack_path);
+			}
+
+			header.magic = s_pack_magic;
+			header.version = s_version;
+			header.build_hash = m_build_hash;
+			header.pack_id = static_cast<u64>(std::chrono::system_clock::now().time_since_epoch().count()) | 1;
+
+			m_pack.trunc(0);
+			m_pack.seek(0);
+
+			if (m_pack.write(&header, sizeof(header)) != sizeof(header))
+			{
+				rsx_log.error("Shader source cache: Failed to initialize %s (%s)", pack_path, fs::g_tls_error);
+				m_pack.close();
+				return;
+			}
+		}
+
+		m_pack_id = header.pack_id;
+		m_pack_size = m_pack.size();
+
+		const u64 start = rsx::uclock();
+
+		if (!load_index())
+		{
+			m_entries.clear();
+			scan_pack(sizeof(pack_header));
+			m_dirty = true;
+		}
+
+		// Drop a partially written trailing record, the process could have been terminated mid-append
+		if (m_pack_size != m_pack.size())
+		{
+			m_pack.trunc(m_pack_size);
+		}
+
+		m_enabled = true;
+
+		rsx_log.notice("Shader source cache: Indexed %u entries from %s in %.3fms", m_entries.size(), pack_path, (rsx::uclock() - start) / 1000.);
+	}
+
+	bool program_source_cache::load_index()
+	{
+		fs::file index(m_path + ".index");
+		if (!index)
+		{
+			return false;
+		}
+
+		index_header header{};
+		if (!index.read(header) || header.magic != s_index_magic || header.version != s_version || header.pack_id != m_pack_id ||
+			header.pack_size > m_pack_size || header.entry_count > index.size() / sizeof(index_entry))
+		{
+			rsx_log.warning("Shader source cache: Index %s.index is stale, rebuilding it from the pack", m_path);
+			return false;
+		}
+
+		std::vector<index_entry> entries(header.entry_count);
+		if (!index.read(entries))
+		{
+			return false;
+		}
+
+		for (const auto& entry : entries)
+		{
+			if (entry.offset < sizeof(pack_header) + sizeof(record_header) || entry.offset + entry.size > header.pack_size)
+			{
+				return false;
+			}
+
+			m_entries.insert_or_assign(entry.key, entry);
+		}
+
+		// Pick up records appended after the index was last written
+		scan_pack(header.pack_size);
+		return true;
+	}
+
+	void program_source_cache::scan_pack(u64 from)
+	{
+		const u64 file_size = m_pack_size;
+
+		m_pack_size = from;
+
+		for (u64 offset = from; offset + sizeof(record_header) <= file_size;)
+		{
+			record_header record{};
+			if (m_pack.read_at(offset, &record, sizeof(record)) != sizeof(record) || record.payload_size > file_size - offset - sizeof(record))
+			{
+				break;
+			}
+
+			// Later records replace earlier ones, an entry is only stored again if its previous copy was damaged
+			m_entries.insert_or_assign(record.key, index_entry{ record.key, offset + sizeof(record), record.payload_size, record.payload_hash });
+
+			offset += sizeof(record) + record.payload_size;
+			m_pack_size = offset;
+		}
+	}
+
+	void program_source_cache::flush_index()
+	{
+		if (!m_pack || !m_dirty)
+		{
+			return;
+		}
+
+		index_header header{};
+		header.magic = s_index_magic;
+		header.version = s_version;
+		header.pack_id = m_pack_id;
+		header.pack_size = m_pack_size;
+		header.entry_count = m_entries.size();
+
+		std::vector<index_entry> entries;
+		entries.reserve(m_entries.size());
+
+		for (const auto& [key, entry] : m_entries)
+		{
+			entries.push_back(entry);
+		}
+
+		const std::string index_path = m_path + ".index";
+
+		fs::pending_file temp(index_path);
+		if (!temp.file)
+		{
+			rsx_log.error("Shader source cache: Failed to create %s (%s)", index_path, fs::g_tls_error);
+			return;
+		}
+
+		temp.file.write(header);
+		temp.file.write(entries);
+
+		if (!temp.commit())
+		{
+			rsx_log.error("Shader source cache: Failed to commit %s (%s)", index_path, fs::g_tls_error);
+			return;
+		}
+
+		m_dirty = false;
+	}
+
+	bool program_source_cache::load(u64 key, utils::serial& ar)
+	{
+		if (m_enabled)
+		{
+			reader_lock lock(m_lock);
+
+			if (auto found = m_entries.find(key); found != m_entries.end())
+			{
+				const index_entry& entry = found->second;
+				std::vector<u8> payload(entry.size);
+
+				// Records are never rewritten in place, reading only needs the entry to stay indexed
+				if (m_pack.read_at(entry.offset, payload.data(), payload.size()) == payload.size() && hash_payload(payload.data(), payload.size()) == entry.hash)
+				{
+					ar.set_reading_state(std::move(payload));
+					m_hits++;
+					return true;
+				}
+
+				// Damaged, it will be appended again after the next decompile
+				rsx_log.warning("Shader source cache: Entry 0x%016llx in %s.pack is damaged", key, m_path);
+
+				lock.upgrade();
+				m_entries.erase(key);
+				m_dirty = true;
+			}
+		}
+
+		m_misses++;
+		return false;
+	}
+
+	void program_source_cache::store(u64 key, const utils::serial& ar, u64 time)
+	{
+		m_decompile_time += time;
+
+		if (!m_enabled)
+		{
+			return;
+		}
+
+		record_header record{};
+		record.key = key;
+		record.payload_hash = hash_payload(ar.data.data(), ar.data.size());
+		record.payload_size = ar.data.size();
+
+		std::lock_guard lock(m_lock);
+
+		if (!m_pack || m_entries.contains(key))
+		{
+			// Another worker decompiled the same program concurrently
+			return;
+		}
+
+		m_pack.seek(m_pack_size);
+
+		if (m_pack.write(&record, sizeof(record)) != sizeof(record) || m_pack.write(ar.data.data(), ar.data.size()) != ar.data.size())
+		{
+			rsx_log.error("Shader source cache: Failed to append to %s.pack (%s)", m_path, fs::g_tls_error);
+			m_pack.trunc(m_pack_size);
+			return;
+		}
+
+		m_entries.emplace(key, index_entry{ key, m_pack_size + sizeof(record), record.payload_size, record.payload_hash });
+		m_pack_size += sizeof(record) + record.payload_size;
+		m_dirty = true;
+	}
+
+	void program_source_cache::on_restored(u64 time)
+	{
+		m_restore_time += time;
+	}
+
+	void program_source_cache::report()
+	{
+		const u32 hits = m_hits.exchange(0);
+		const u32 misses = m_misses.exchange(0);
+		const u64 restore_time = m_restore_time.exchange(0);
+		const u64 decompile_time = m_decompile_time.exchange(0);
+
+		if (!hits && !misses)
+		{
+			return;
+		}
+
+		rsx_log.notice("Shader source cache: %u hits restored in %.3fms (%.3fus avg), %u misses decompiled in %.3fms (%.3fus avg)",
+			hits, restore_time / 1000., hits ? restore_time / static_cast<f64>(hits) : 0.,
+			misses, decompile_time / 1000., misses ? decompile_time / static_cast<f64>(misses) : 0.);
+	}
+
+	u64 program_source_cache::get_key(const RSXVertexProgram& prog, u64 options_hash)
+	{
+		usz hash = rpcs3::hash64(rpcs3::fnv_seed, program_hash_util::vertex_program_utils::get_vertex_program_ucode_hash(prog));
+		hash = rpcs3::hash64(hash, u8{0}); // Vertex program domain
+		hash = rpcs3::hash64(hash, options_hash);
+		hash = rpcs3::hash64(hash, prog.output_mask);
+		hash = rpcs3::hash64(hash, prog.texture_state.texture_dimensions);
+		hash = rpcs3::hash64(hash, prog.texture_state.multisampled_textures);
+		hash = rpcs3::hash64(hash, ::size32(prog.data));
+		hash = rpcs3::hash64(hash, prog.entry - prog.base_address);
+
+		for (const u32 target : prog.jump_table)
+		{
+			hash = rpcs3::hash64(hash, target);
+		}
+
+		// The ucode hash skips inactive slots, but instruction indices end up in the generated labels
+		u64 mask_bits = 0;
+
+		for (u32 i = 0; i < prog.data.size() / 4; i++)
+		{
+			mask_bits |= u64{prog.instruction_mask[i]} << (i % 64);
+
+			if (i % 64 == 63)
+			{
+				hash = rpcs3::hash64(hash, std::exchange(mask_bits, 0));
+			}
+		}
+
+		hash = rpcs3::hash64(hash, mask_bits);
+		return hash;
+	}
+
+	u64 program_source_cache::get_key(const RSXFragmentProgram& prog, u64 options_hash)
+	{
+		usz hash = rpcs3::hash64(rpcs3::fnv_seed, program_hash_util::fragment_program_utils::get_fragment_program_ucode_hash(prog));
+		hash = rpcs3::hash64(hash, u8{1}); // Fragment program domain
+		hash = rpcs3::hash64(hash, options_hash);
+		hash = rpcs3::hash64(hash, prog.ctrl);
+		hash = rpcs3::hash64(hash, prog.two_sided_lighting);
+		hash = rpcs3::hash64(hash, prog.texcoord_control_mask);
+		hash = rpcs3::hash64(hash, prog.texture_state.texture_dimensions);
+		hash = rpcs3::hash64(hash, prog.texture_state.shadow_textures);
+		hash = rpcs3::hash64(hash, prog.texture_state.redirected_textures);
+		hash = rpcs3::hash64(hash, prog.texture_state.multisampled_textures);
+		hash = rpcs3::hash64(hash, prog.ucode_length);
+		return hash;
+	}
+}
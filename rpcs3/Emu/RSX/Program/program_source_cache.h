@@ -0,0 +1,109 @@
+#pragma once
+
+#include "Utilities/File.h"
+#include "Utilities/mutex.h"
+#include "util/atomic.hpp"
+#include "util/serialization.hpp"
+
+#include <string>
+#include <unordered_map>
+
+struct RSXVertexProgram;
+struct RSXFragmentProgram;
+
+namespace rsx
+{
+	/**
+	 * On-disk cache of decompiled shader sources.
+	 * Entries are keyed by the program ucode and decompiler-relevant state, combined with a backend-provided
+	 * hash of the decompiler options. The payload is opaque to the cache; each backend serializes the
+	 * source alongside whatever metadata its decompiler would otherwise have produced.
+	 * <name>.pack holds the entries (record header followed by the payload) and is only ever appended to.
+	 * <name>.index lists the record locations so that opening does not need to walk the pack.
+	 * Only the locations are kept in memory, payloads are read from the pack on demand.
+	 */
+	class program_source_cache
+	{
+		struct pack_header
+		{
+			u32 magic;
+			u32 version;
+			u64 build_hash;
+			u64 pack_id;
+		};
+
+		struct record_header
+		{
+			u64 key;
+			u64 payload_hash;
+			u64 payload_size;
+		};
+
+		struct index_header
+		{
+			u32 magic;
+			u32 version;
+			u64 pack_id;
+			u64 pack_size;
+			u64 entry_count;
+		};
+
+		struct index_entry
+		{
+			u64 key;
+			u64 offset; // Byte offset of the payload inside the pack
+			u64 size;
+			u64 hash;
+		};
+
+		static constexpr u32 s_pack_magic = "RSSC"_u32;
+		static constexpr u32 s_index_magic = "RSSI"_u32;
+		static constexpr u32 s_version = 2;
+
+		shared_mutex m_lock;
+		fs::file m_pack;
+		std::unordered_map<u64, index_entry> m_entries;
+		std::string m_path;
+		u64 m_build_hash = 0;
+		u64 m_pack_id = 0;
+		u64 m_pack_size = 0;
+		bool m_enabled = false;
+		bool m_dirty = false;
+
+		atomic_t<u32> m_hits = 0;
+		atomic_t<u32> m_misses = 0;
+		atomic_t<u64> m_restore_time = 0;
+		atomic_t<u64> m_decompile_time = 0;
+
+		bool load_index();
+		void scan_pack(u64 from);
+		void flush_index();
+
+	public:
+		program_source_cache() = default;
+		~program_source_cache();
+
+		program_source_cache(const program_source_cache&) = delete;
+		program_source_cache& operator=(const program_source_cache&) = delete;
+
+		// Opens or creates <path>.pack and loads the entry locations
+		void open(const std::string& path);
+
+		// Fetches an entry. On success, ar is left in reading state over the payload
+		bool load(u64 key, utils::serial& ar);
+
+		// Saves a freshly decompiled entry, time is the decompilation cost in microseconds
+		void store(u64 key, const utils::serial& ar, u64 time);
+
+		// Accounts for time spent restoring an entry returned by load
+		void on_restored(u64 time);
+
+		// Logs hit/miss counts and timings accumulated since the last report
+		void report();
+
+		bool enabled() const { return m_enabled; }
+
+		static u64 get_key(const RSXVertexProgram& prog, u64 options_hash);
+		static u64 get_key(const RSXFragmentProgram& prog, u64 options_hash);
+	};
+}
@@ -4,9 +4,11 @@
 #include "RSXThread.h"
 #include "Capture/rsx_capture.h"
 #include "Common/time.hpp"
+#include "Common/timeline.h"
 #include "Core/RSXReservationLock.hpp"
 #include "Emu/Memory/vm_reservation.h"
 #include "Emu/Cell/lv2/sys_rsx.h"
+#include "Emu/perf_meter.hpp"
 #include "util/asm.hpp"
 
 #include <bitset>
@@ -20,11 +22,476 @@ namespace rsx
 {
 	namespace FIFO
 	{
+		struct FIFO_control::predecoder
+		{
+			static constexpr u32 ring_size = 4096;
+
+			RsxDmaControl* const ctrl;
+			const rsx_iomap_table* const iotable;
+
+			std::array<predecoded_command, ring_size> ring{};
+			atomic_t<u32> push_pos = 0;
+			atomic_t<u32> pop_pos = 0;
+
+			// Speculation request, published by the RSX thread. Odd values are active requests.
+			atomic_t<u32> epoch = 0;
+			atomic_t<u32> start_get = 0;
+			atomic_t<u32> start_ret = RSX_CALL_STACK_EMPTY;
+			atomic_t<u32> start_code = 0;
+			atomic_t<u32> start_iomap_version = 0;
+
+			predecoder(RsxDmaControl* _ctrl, const rsx_iomap_table* _iotable)
+				: ctrl(_ctrl), iotable(_iotable)
+			{}
+
+			enum class fetch_status : u8
+			{
+				ok,
+				halt,
+				abandon
+			};
+
+			bool is_abandoned(u32 _epoch) const
+			{
+				return epoch != _epoch || thread_ctrl::state() == thread_state::aborting;
+			}
+
+			bool push(u32 _epoch, const predecoded_command& entry)
+			{
+				const u32 pos = push_pos.raw();
+
+				while (pos - pop_pos.load() >= ring_size)
+				{
+					if (is_abandoned(_epoch))
+					{
+						return false;
+					}
+
+					std::this_thread::yield();
+				}
+
+				ring[pos % ring_size] = entry;
+				push_pos.release(pos + 1);
+				return true;
+			}
+
+			void decode(u32 _epoch)
+			{
+				const u32 iomap_version = start_iomap_version;
+				u32 get = start_get;
+				u32 ret = start_ret;
+				u32 code_start = start_code;
+				u32 last_end = get;
+
+				// Words copied out of guest memory, up to the end of the current 128 byte line
+				// The copy goes through vm::try_access, so the range cannot be unmapped while it is being read
+				std::array<be_t<u32>, 32> words;
+				u32 words_get = 0;
+				u32 words_ea = 0;
+				u32 words_size = 0;
+
+				const auto emit = [&](u32 reg, u32 value, u32 arg_get, u32 ea, u32 cmd_ea, u32 cmd, u32 remaining)
+				{
+					return push(_epoch, predecoded_command{{reg, value}, arg_get, ea, cmd_ea, cmd, remaining, ret, code_start, _epoch});
+				};
+
+				const auto fetch = [&](u32 addr, u32& out, u32& ea, bool is_header)
+				{
+					if (addr - words_get < words_size)
+					{
+						ea = words_ea + (addr - words_get);
+						out = words[(addr - words_get) / 4];
+						return fetch_status::ok;
+					}
+
+					for (u32 spin = 0;; spin++)
+					{
+						if (is_abandoned(_epoch))
+						{
+							return fetch_status::abandon;
+						}
+
+						if (iotable->version != iomap_version)
+						{
+							return fetch_status::halt;
+						}
+
+						if ((ctrl->put & ~3) != addr)
+						{
+							break;
+						}
+
+						if (is_header && addr != last_end)
+						{
+							// Expose flow control resolved so far so GET can catch up with PUT
+							if (!emit(FIFO_EMPTY, 0, addr, umax, umax, 0, 0))
+							{
+								return fetch_status::abandon;
+							}
+
+							last_end = addr;
+						}
+
+						if (spin < 64)
+						{
+							std::this_thread::yield();
+						}
+						else
+						{
+							thread_ctrl::wait_for(50);
+						}
+					}
+
+					ea = iotable->get_addr(addr);
+
+					if (ea == umax)
+					{
+						return fetch_status::halt;
+					}
+
+					// Stop at PUT if it is inside the line (IO pages are 1MB, so the line is contiguous in memory)
+					const u32 put = ctrl->put & ~3;
+					const u32 size = addr < put && put < (addr | 127) + 1 ? put - addr : (addr | 127) + 1 - addr;
+
+					if (!vm::try_access(ea, words.data(), size, false))
+					{
+						return fetch_status::halt;
+					}
+
+					words_get = addr;
+					words_ea = ea;
+					words_size = size;
+					out = words[0];
+					return fetch_status::ok;
+				};
+
+				const auto halt = [&]()
+				{
+					// Hand the command back to the RSX thread; it will re-arm the decoder once it has stepped over it
+					emit(FIFO_BUSY, 0, get, umax, umax, 0, 0);
+				};
+
+				const auto emit_flow = [&](u32 cmd, u32 ea)
+				{
+					// Flow is already resolved here, so the entry carries the state to continue with
+					words_size = 0;
+					return emit(FIFO_NOP, 0, get, umax, ea, cmd, 0);
+				};
+
+				while (true)
+				{
+					u32 cmd, ea;
+
+					if (const auto status = fetch(get, cmd, ea, true); status != fetch_status::ok)
+					{
+						if (status == fetch_status::halt) halt();
+						return;
+					}
+
+					if (cmd & RSX_METHOD_NON_METHOD_CMD_MASK)
+					{
+						if ((cmd & RSX_METHOD_OLD_JUMP_CMD_MASK) == RSX_METHOD_OLD_JUMP_CMD ||
+							(cmd & RSX_METHOD_NEW_JUMP_CMD_MASK) == RSX_METHOD_NEW_JUMP_CMD)
+						{
+							const u32 offs = cmd & ((cmd & RSX_METHOD_OLD_JUMP_CMD_MASK) == RSX_METHOD_OLD_JUMP_CMD ? RSX_METHOD_OLD_JUMP_OFFSET_MASK : RSX_METHOD_NEW_JUMP_OFFSET_MASK);
+
+							if (offs == get)
+							{
+								// Jump to self, the application is going to patch it
+								halt();
+								return;
+							}
+
+							get = code_start = offs;
+
+							if (!emit_flow(cmd, ea))
+							{
+								return;
+							}
+
+							continue;
+						}
+
+						if ((cmd & RSX_METHOD_CALL_CMD_MASK) == RSX_METHOD_CALL_CMD && ret == RSX_CALL_STACK_EMPTY)
+						{
+							ret = get + 4;
+							get = code_start = cmd & RSX_METHOD_CALL_OFFSET_MASK;
+
+							if (!emit_flow(cmd, ea))
+							{
+								return;
+							}
+
+							continue;
+						}
+
+						if ((cmd & RSX_METHOD_RETURN_MASK) == RSX_METHOD_RETURN_CMD && ret != RSX_CALL_STACK_EMPTY)
+						{
+							get = code_start = std::exchange(ret, RSX_CALL_STACK_EMPTY);
+
+							if (!emit_flow(cmd, ea))
+							{
+								return;
+							}
+
+							continue;
+						}
+
+						// Nested call, orphan return or malformed command; leave error handling to the RSX thread
+						halt();
+						return;
+					}
+
+					const u32 count = (cmd >> 18) & 0x7ff;
+
+					if (!count)
+					{
+						// NOP
+						get += 4;
+
+						if (!emit(FIFO_NOP, 0, get, umax, ea, cmd, 0))
+						{
+							return;
+						}
+
+						continue;
+					}
+
+					const u32 reg = cmd & 0xfffc;
+					const u32 inc = ((cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? 0 : 4;
+
+					if ((NV406E_SEMAPHORE_ACQUIRE - (reg >> 2)) < (inc ? count : 1))
+					{
+						// The application may still be writing the commands guarded by the semaphore
+						halt();
+						return;
+					}
+
+					const u32 cmd_ea = ea;
+
+					for (u32 i = 0; i < count; i++)
+					{
+						const u32 arg_get = get + 4 + i * 4;
+						u32 arg;
+
+						if (const auto status = fetch(arg_get, arg, ea, false); status != fetch_status::ok)
+						{
+							if (status == fetch_status::halt) halt();
+							return;
+						}
+
+						if (!emit(reg + inc * i, arg, arg_get, ea, cmd_ea, cmd, count - 1 - i))
+						{
+							return;
+						}
+					}
+
+					get += (count + 1) * 4;
+					last_end = get;
+				}
+			}
+
+			void operator()()
+			{
+				if (g_cfg.core.thread_scheduler != thread_scheduler_mode::os)
+				{
+					thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::rsx_aux));
+				}
+
+				u32 done_epoch = 0;
+
+				while (thread_ctrl::state() != thread_state::aborting)
+				{
+					const u32 current = epoch;
+
+					if (current == done_epoch || !(current & 1))
+					{
+						thread_ctrl::wait_on(epoch, current);
+						continue;
+					}
+
+					done_epoch = current;
+					decode(current);
+				}
+			}
+
+			static constexpr auto thread_name = "RSX FIFO Decoder"sv;
+		};
+
 		FIFO_control::FIFO_control(::rsx::thread* pctrl)
 		{
 			m_thread = pctrl;
 			m_ctrl = pctrl->ctrl;
 			m_iotable = &pctrl->iomap_table;
+
+			if (g_cfg.core.rsx_fifo_predecode && !g_cfg.core.rsx_fifo_accuracy)
+			{
+				m_predecoder = std::make_shared<named_thread<predecoder>>(m_ctrl, m_iotable);
+			}
+		}
+
+		void FIFO_control::arm_predecoder()
+		{
+			auto& dec = *m_predecoder;
+
+			m_iomap_version = m_iotable->version;
+			dec.start_get.release(m_internal_get);
+			dec.start_ret.release(m_thread->fifo_ret_addr);
+			dec.start_code.release(m_thread->last_known_code_start);
+			dec.start_iomap_version.release(m_iomap_version);
+
+			// Only the RSX thread modifies the epoch
+			dec.epoch.release(++m_predecode_epoch);
+			dec.epoch.notify_one();
+
+			m_predecode_armed = true;
+			m_predecode_halt = umax;
+		}
+
+		void FIFO_control::disarm_predecoder(u32 halt_get)
+		{
+			m_predecode_halt = halt_get;
+
+			if (!m_predecode_armed)
+			{
+				return;
+			}
+
+			// Abandon in-flight speculation, stale entries are dropped when encountered
+			m_predecode_armed = false;
+			m_predecoder->epoch.release(++m_predecode_epoch);
+		}
+
+		const predecoded_command* FIFO_control::peek_predecoded()
+		{
+			auto& dec = *m_predecoder;
+
+			for (u32 pos = dec.pop_pos.raw(); pos != dec.push_pos.load(); pos++)
+			{
+				const auto& entry = dec.ring[pos % predecoder::ring_size];
+
+				if (entry.epoch == m_predecode_epoch)
+				{
+					return &entry;
+				}
+
+				dec.pop_pos.release(pos + 1);
+			}
+
+			return nullptr;
+		}
+
+		bool FIFO_control::check_predecoded(const predecoded_command& entry) const
+		{
+			// The decoder runs ahead of GET and the application may have patched the buffer since, compare the words again
+			// The header is only compared for the first argument, the regular path does not read it again within a packet either
+			if (entry.data.reg == FIFO_NOP || entry.remaining + 1 == ((entry.cmd >> 18) & 0x7ff))
+			{
+				if (vm::read32(entry.cmd_ptr) != entry.cmd)
+				{
+					return false;
+				}
+			}
+
+			return entry.data.reg > 0xffff || vm::read32(entry.args_ptr) == entry.data.value;
+		}
+
+		void FIFO_control::consume_predecoded(const predecoded_command& entry)
+		{
+			m_internal_get = entry.get;
+			m_thread->fifo_ret_addr = entry.ret_addr;
+			m_thread->last_known_code_start = entry.code_start;
+
+			if (entry.data.reg <= 0xffff)
+			{
+				m_cmd = entry.cmd;
+				m_command_reg = entry.data.reg;
+				m_command_inc = ((m_cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? 0 : 4;
+				m_remaining_commands = entry.remaining;
+				m_args_ptr = entry.args_ptr;
+			}
+
+			m_predecoder->pop_pos.release(m_predecoder->pop_pos.raw() + 1);
+		}
+
+		bool FIFO_control::read_predecoded(register_pair& data)
+		{
+			if (!m_predecode_armed)
+			{
+				if (m_remaining_commands || m_memwatch_addr || m_internal_get == m_predecode_halt)
+				{
+					// Finish the current packet or step over the command the decoder stopped at first
+					return false;
+				}
+
+				arm_predecoder();
+			}
+			else if (m_iotable->version != m_iomap_version) [[unlikely]]
+			{
+				// IO layout changed under speculation
+				disarm_predecoder();
+				return false;
+			}
+
+			const predecoded_command* entry;
+
+			// Step over NOPs and resolved flow control
+			while ((entry = peek_predecoded()) && entry->data.reg == FIFO_NOP)
+			{
+				if (!check_predecoded(*entry))
+				{
+					disarm_predecoder(m_internal_get);
+					return false;
+				}
+
+				consume_predecoded(*entry);
+			}
+
+			if (!entry)
+			{
+				data.reg = read_put<false>() == m_internal_get ? FIFO_EMPTY : FIFO_BUSY;
+				return true;
+			}
+
+			switch (entry->data.reg)
+			{
+			case FIFO_EMPTY:
+			{
+				// Decoder caught up with PUT after resolving flow control
+				consume_predecoded(*entry);
+				sync_get();
+				data.reg = FIFO_EMPTY;
+				return true;
+			}
+			case FIFO_BUSY:
+			{
+				// Speculation stopped, continue on the regular path
+				if (m_remaining_commands)
+				{
+					// Stopped in the middle of a packet, the current state already describes it
+					m_predecoder->pop_pos.release(m_predecoder->pop_pos.raw() + 1);
+					disarm_predecoder();
+					return false;
+				}
+
+				consume_predecoded(*entry);
+				disarm_predecoder(m_internal_get);
+				return false;
+			}
+			default:
+			{
+				if (!check_predecoded(*entry))
+				{
+					// Patched since it was decoded, re-read it on the regular path
+					m_remaining_commands ? disarm_predecoder() : disarm_predecoder(m_internal_get);
+					return false;
+				}
+
+				data = entry->data;
+				consume_predecoded(*entry);
+				return true;
+			}
+			}
 		}
 
 		void FIFO_control::sync_get() const
@@ -34,6 +501,11 @@ namespace rsx
 
 		void FIFO_control::restore_state(u32 cmd, u32 count)
 		{
+			if (m_predecoder)
+			{
+				disarm_predecoder();
+			}
+
 			m_cmd = cmd;
 			m_command_inc = ((m_cmd & RSX_METHOD_NON_INCREMENT_CMD_MASK) == RSX_METHOD_NON_INCREMENT_CMD) ? 0 : 4;
 			m_remaining_commands = count;
@@ -203,6 +675,11 @@ namespace rsx
 		{
 			invalidate_cache();
 
+			if (m_predecoder)
+			{
+				disarm_predecoder();
+			}
+
 			if (spin_cmd && m_ctrl->get == get)
 			{
 				m_memwatch_addr = get;
@@ -234,6 +711,26 @@ namespace rsx
 			// Fast read with no processing, only safe inside a PACKET_BEGIN+count block
 			if (m_remaining_commands)
 			{
+				if (m_predecode_armed)
+				{
+					const auto entry = peek_predecoded();
+
+					if (!entry || entry->data.reg > 0xffff)
+					{
+						return false;
+					}
+
+					if (check_predecoded(*entry))
+					{
+						data = entry->data;
+						consume_predecoded(*entry);
+						return true;
+					}
+
+					// Patched since it was decoded, continue the packet on the regular path
+					disarm_predecoder();
+				}
+
 				bool ok{};
 				u32 arg = 0;
 
@@ -280,6 +777,30 @@ namespace rsx
 		// Beware, can be easily misused
 		bool FIFO_control::skip_methods(u32 count)
 		{
+			for (; m_predecode_armed && count && m_remaining_commands; count--)
+			{
+				// The arguments are known to be below PUT, wait for the decoder to emit them
+				const predecoded_command* entry;
+
+				while (!(entry = peek_predecoded()) && !m_thread->is_stopped())
+				{
+					utils::pause();
+				}
+
+				if (!entry || entry->data.reg > 0xffff || !check_predecoded(*entry))
+				{
+					disarm_predecoder();
+					break;
+				}
+
+				consume_predecoded(*entry);
+			}
+
+			if (m_predecode_armed)
+			{
+				return m_remaining_commands != 0;
+			}
+
 			if (m_remaining_commands > count)
 			{
 				m_command_reg += m_command_inc * count;
@@ -296,11 +817,21 @@ namespace rsx
 
 		void FIFO_control::abort()
 		{
+			if (m_predecoder)
+			{
+				disarm_predecoder();
+			}
+
 			m_remaining_commands = 0;
 		}
 
 		void FIFO_control::read(register_pair& data)
 		{
+			if (m_predecoder && read_predecoded(data))
+			{
+				return;
+			}
+
 			if (m_remaining_commands)
 			{
 				// Previous block aborted to wait for PUT pointer
@@ -452,11 +983,78 @@ namespace rsx
 
 				reset(false);
 				fifo_hint = optimization_hint::application_not_compatible;
+				record_decision(decision::disabled_incompatible, 0, 0);
+			}
+		}
+
+		void flattening_helper::record_decision(decision result, u32 total_draw_count, u32 merged_count)
+		{
+			m_decision_history[m_decision_count++ % decision_history_size] = { m_statistics.frames, total_draw_count, merged_count, result };
+
+			rsx_log.trace("FIFO flattening %s at frame %u (%u draws, %u merged)", get_decision_name(result), m_statistics.frames, total_draw_count, merged_count);
+			timeline::record_instant(timeline::event_type::flatten_decision, static_cast<u64>(result));
+		}
+
+		std::vector<flattening_helper::decision_record> flattening_helper::get_decision_history() const
+		{
+			std::vector<decision_record> result;
+			const u32 first = m_decision_count > decision_history_size ? m_decision_count - decision_history_size : 0;
+
+			for (u32 i = first; i < m_decision_count; i++)
+			{
+				result.push_back(m_decision_history[i % decision_history_size]);
+			}
+
+			return result;
+		}
+
+		std::string_view flattening_helper::get_decision_name(decision result)
+		{
+			switch (result)
+			{
+			case decision::none: return "none";
+			case decision::enabled: return "enabled";
+			case decision::disabled_no_benefit: return "disabled (no benefit)";
+			case decision::disabled_low_load: return "disabled (low load)";
+			case decision::disabled_incompatible: return "disabled (incompatible)";
 			}
+
+			return "unknown";
 		}
 
 		void flattening_helper::evaluate_performance(u32 total_draw_count)
 		{
+			// The draw count only includes draws which reached the backend
+			const u32 merged_count = num_collapsed;
+			const u32 submitted_count = total_draw_count + merged_count;
+
+			m_statistics.frames++;
+			m_statistics.flattened_frames += enabled;
+			m_statistics.draw_count += submitted_count;
+			m_statistics.merged_count += merged_count;
+
+			if (g_cfg.core.perf_report) [[unlikely]]
+			{
+				// Split frame times by flattening state so both can be compared in the performance report
+				if (m_frame_start_tsc)
+				{
+					if (enabled)
+					{
+						perf_stat<"FLAT_ON"_u64>::push(m_frame_start_tsc);
+					}
+					else
+					{
+						perf_stat<"FLAT_OFF"_u64>::push(m_frame_start_tsc);
+					}
+				}
+
+				m_frame_start_tsc = utils::get_tsc();
+			}
+			else
+			{
+				m_frame_start_tsc = 0;
+			}
+
 			if (!enabled)
 			{
 				if (fifo_hint == optimization_hint::application_not_compatible)
@@ -497,6 +1095,11 @@ namespace rsx
 					fifo_hint = load_low;
 				}
 
+				if (!enabled)
+				{
+					record_decision(fifo_hint == load_low ? decision::disabled_low_load : decision::disabled_no_benefit, submitted_count, merged_count);
+				}
+
 				reset(enabled);
 			}
 			else
@@ -510,6 +1113,8 @@ namespace rsx
 					ensure(in_begin_end == false); // "Incorrect initial state"
 					ensure(num_collapsed == 0);
 					enabled = true;
+
+					record_decision(decision::enabled, submitted_count, 0);
 				}
 			}
 		}
@@ -601,6 +1206,16 @@ namespace rsx
 		}
 	}
 
+	void thread::record_fifo_drain()
+	{
+		if (rsx::timeline::enabled() && performance_counters.FIFO_busy_timestamp)
+		{
+			rsx::timeline::record(rsx::timeline::event_type::fifo_drain, performance_counters.FIFO_busy_timestamp, rsx::nclock());
+		}
+
+		performance_counters.FIFO_busy_timestamp = 0;
+	}
+
 	void thread::run_FIFO()
 	{
 		FIFO::register_pair command;
@@ -617,6 +1232,7 @@ namespace rsx
 				if (performance_counters.state == FIFO::state::running)
 				{
 					performance_counters.FIFO_idle_timestamp = rsx::uclock();
+					record_fifo_drain();
 					performance_counters.state = FIFO::state::nop;
 				}
 
@@ -627,6 +1243,7 @@ namespace rsx
 				if (performance_counters.state == FIFO::state::running)
 				{
 					performance_counters.FIFO_idle_timestamp = rsx::uclock();
+					record_fifo_drain();
 					performance_counters.state = FIFO::state::empty;
 				}
 				else
@@ -662,6 +1279,7 @@ namespace rsx
 					if (performance_counters.state == FIFO::state::running)
 					{
 						performance_counters.FIFO_idle_timestamp = rsx::uclock();
+						record_fifo_drain();
 						sync_point_request.release(true);
 					}
 
@@ -733,6 +1351,11 @@ namespace rsx
 		{
 			performance_counters.state = FIFO::state::running;
 
+			if (rsx::timeline::enabled())
+			{
+				performance_counters.FIFO_busy_timestamp = rsx::nclock();
+			}
+
 			// Hack: Delay FIFO wake-up according to setting
 			// NOTE: The typical spin setup is a NOP followed by a jump-to-self
 			// NOTE: There is a small delay when the jump address is dynamically edited by cell
@@ -846,6 +1469,7 @@ namespace rsx
 			const u32 reg = (command.reg & 0xffff) >> 2;
 			const u32 value = command.value;
 
+			m_frame_stats.register_writes++;
 			method_registers.decode(reg, value);
 
 			if (auto method = methods[reg])
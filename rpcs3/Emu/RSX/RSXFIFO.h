@@ -3,10 +3,16 @@
 #include "util/types.hpp"
 #include "Emu/RSX/gcm_enums.h"
 
+#include <array>
 #include <span>
+#include <string_view>
+#include <vector>
 
 struct RsxDmaControl;
 
+template <typename T>
+class named_thread;
+
 namespace rsx
 {
 	class thread;
@@ -60,6 +66,20 @@ namespace rsx
 			}
 		};
 
+		// Method write resolved ahead of time by the FIFO pre-decoder
+		struct predecoded_command
+		{
+			register_pair data;  // Method write, FIFO_NOP for a NOP or flow control word, FIFO_EMPTY for a position marker or FIFO_BUSY when speculation stopped
+			u32 get;             // FIFO offset of the argument (FIFO_NOP: offset execution continues at)
+			u32 args_ptr;        // Effective address of the argument
+			u32 cmd_ptr;         // Effective address of the method header or FIFO_NOP word
+			u32 cmd;             // Method header the argument belongs to (FIFO_NOP: the word itself)
+			u32 remaining;       // Arguments left in the packet after this one
+			u32 ret_addr;        // Call stack state after flow control resolution
+			u32 code_start;
+			u32 epoch;
+		};
+
 		class flattening_helper
 		{
 			enum register_props : u8
@@ -104,6 +124,35 @@ namespace rsx
 				return register_properties;
 			}();
 
+		public:
+			enum class decision : u8
+			{
+				none,
+				enabled,             // High draw call pressure, flattening was switched on
+				disabled_no_benefit, // Too few draws could be merged
+				disabled_low_load,   // Draw call pressure dropped
+				disabled_incompatible
+			};
+
+			struct decision_record
+			{
+				u64 frame;        // Index of the evaluated frame
+				u32 draw_count;   // Draws submitted by the application, including merged ones
+				u32 merged_count; // Draws folded into the previous one
+				decision result;
+			};
+
+			struct statistics
+			{
+				u64 frames = 0;
+				u64 flattened_frames = 0;
+				u64 draw_count = 0;
+				u64 merged_count = 0;
+			};
+
+		private:
+			static constexpr u32 decision_history_size = 32;
+
 			u32 deferred_primitive = 0;
 			u32 draw_count = 0;
 			bool in_begin_end = false;
@@ -112,7 +161,13 @@ namespace rsx
 			u32  num_collapsed = 0;
 			optimization_hint fifo_hint = unknown;
 
+			std::array<decision_record, decision_history_size> m_decision_history{};
+			u32 m_decision_count = 0;
+			statistics m_statistics{};
+			u64 m_frame_start_tsc = 0;
+
 			void reset(bool _enabled);
+			void record_decision(decision result, u32 total_draw_count, u32 merged_count);
 
 		public:
 			flattening_helper() = default;
@@ -121,6 +176,16 @@ namespace rsx
 			u32 get_primitive() const { return deferred_primitive; }
 			bool is_enabled() const { return enabled; }
 
+			// Draws merged since the last evaluation
+			u32 get_merged_count() const { return num_collapsed; }
+
+			const statistics& get_statistics() const { return m_statistics; }
+
+			// State changes of the flattener, oldest first
+			std::vector<decision_record> get_decision_history() const;
+
+			static std::string_view get_decision_name(decision result);
+
 			void force_disable();
 			void evaluate_performance(u32 total_draw_count);
 			inline flatten_op test(register_pair& command);
@@ -147,6 +212,21 @@ namespace rsx
 			u32 m_cache_size = 0;
 			alignas(64) std::byte m_cache[8][128];
 
+			// Optional pre-decoder which walks the command buffer ahead of the RSX thread
+			struct predecoder;
+			std::shared_ptr<named_thread<predecoder>> m_predecoder;
+			u32 m_predecode_epoch = 0;
+			u32 m_predecode_halt = umax;
+			u32 m_iomap_version = 0;
+			bool m_predecode_armed = false;
+
+			void arm_predecoder();
+			void disarm_predecoder(u32 halt_get = umax);
+			const predecoded_command* peek_predecoded();
+			bool check_predecoded(const predecoded_command& entry) const;
+			void consume_predecoded(const predecoded_command& entry);
+			bool read_predecoded(register_pair& data);
+
 		public:
 			FIFO_control(rsx::thread* pctrl);
 			~FIFO_control() = default;
@@ -2,24 +2,64 @@
 
 #include "Emu/Memory/vm.h"
 #include "Common/BufferUtils.h"
+#include "Common/time.hpp"
+#include "Common/timeline.h"
 #include "Core/RSXReservationLock.hpp"
 #include "RSXOffload.h"
 #include "RSXThread.h"
 
 #include <thread>
 #include "util/asm.hpp"
+#include "util/sysinfo.hpp"
 
 namespace rsx
 {
 	struct dma_manager::offload_thread
 	{
+		const dma_manager& m_manager;
+		const u32 m_index;
+
 		lf_queue<transport_packet> m_work_queue;
 		atomic_t<u64> m_enqueued_count = 0;
 		atomic_t<u64> m_processed_count = 0;
+		atomic_t<u64> m_fence_passed = 0;
 		transport_packet* m_current_job = nullptr;
 
 		thread_base* current_thread_ = nullptr;
 
+		offload_thread(const dma_manager& manager, u32 index)
+			: m_manager(manager), m_index(index)
+		{}
+
+		template <typename... Args>
+		void enqueue(Args&&... args)
+		{
+			m_enqueued_count++;
+			m_work_queue.push(std::forward<Args>(args)...);
+		}
+
+		bool is_idle() const
+		{
+			return m_enqueued_count.load() <= m_processed_count.load();
+		}
+
+		void wait_for_fence(u64 fence_id) const
+		{
+			// Every other worker must have consumed the transfers queued before this fence
+			for (const auto& worker : m_manager.m_workers)
+			{
+				if (worker->m_index == m_index)
+				{
+					continue;
+				}
+
+				while (worker->m_fence_passed.load() < fence_id && thread_ctrl::state() != thread_state::aborting)
+				{
+					utils::pause();
+				}
+			}
+		}
+
 		void operator ()()
 		{
 			if (!g_cfg.video.multithreaded_rsx)
@@ -33,7 +73,7 @@ namespace rsx
 
 			if (g_cfg.core.thread_scheduler != thread_scheduler_mode::os)
 			{
-				thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::rsx));
+				thread_ctrl::set_thread_affinity_mask(thread_ctrl::get_affinity_mask(thread_class::rsx_aux));
 			}
 
 			while (thread_ctrl::state() != thread_state::aborting)
@@ -51,11 +91,6 @@ namespace rsx
 						std::memcpy(job.dst, job.src, job.length);
 						break;
 					}
-					case vector_copy:
-					{
-						std::memcpy(job.dst, job.opt_storage.data(), job.length);
-						break;
-					}
 					case index_emulate:
 					{
 						write_index_array_for_non_indexed_non_native_primitive_to_buffer(static_cast<char*>(job.dst), static_cast<rsx::primitive_type>(job.aux_param0), job.length);
@@ -63,9 +98,15 @@ namespace rsx
 					}
 					case callback:
 					{
+						wait_for_fence(job.fence_id);
 						rsx::get_current_renderer()->renderctl(job.aux_param0, job.src);
 						break;
 					}
+					case fence:
+					{
+						m_fence_passed.release(job.fence_id);
+						break;
+					}
 					default: fmt::throw_exception("Unreachable");
 					}
 
@@ -84,30 +125,115 @@ namespace rsx
 			m_processed_count = -1;
 			m_processed_count.notify_all();
 		}
-
-		static constexpr auto thread_name = "RSX Offloader"sv;
 	};
 
+	// Defined here as the workers are only complete in this translation unit
+	dma_manager::dma_manager() = default;
+
+	dma_manager::~dma_manager() = default;
+
 	// initialization
 	void dma_manager::init()
 	{
-		m_thread = std::make_shared<named_thread<offload_thread>>();
+		u32 worker_count = g_cfg.video.offload_thread_count;
+
+		if (!worker_count)
+		{
+			// A single worker keeps up with vertex streaming on smaller hosts
+			worker_count = std::clamp<u32>(utils::get_thread_count() / 8, 1, max_workers);
+		}
+
+		m_workers.clear();
+		m_fence_id = 0;
+
+		for (u32 i = 0; i < worker_count; i++)
+		{
+			m_workers.emplace_back(std::make_shared<named_thread<offload_thread>>(fmt::format("RSX Offloader %u", i), *this, i));
+		}
+
+		if (!g_cfg.video.multithreaded_rsx)
+		{
+			return;
+		}
+
+		if (const u32 limit = g_cfg.video.offload_immediate_transfer_limit)
+		{
+			max_immediate_transfer_size = limit;
+		}
+		else
+		{
+			calibrate();
+		}
+
+		rsx_log.notice("DMA offload: %u workers, transfers up to %u bytes are done inline", worker_count, max_immediate_transfer_size);
 	}
 
-	// General transport
-	void dma_manager::copy(void *dst, std::vector<u8>& src, u32 length) const
+	void dma_manager::calibrate()
 	{
-		if (length <= max_immediate_transfer_size || !g_cfg.video.multithreaded_rsx)
+		// Offloading pays off once copying inline costs the RSX thread more than queueing the transfer does
+		constexpr u32 copy_sample_size = 256 * 1024;
+		constexpr u32 copy_iterations = 32;
+		constexpr u32 enqueue_iterations = 1024;
+		constexpr u32 enqueue_sample_size = 16;
+
+		std::vector<u8> src(copy_sample_size, 0x5a);
+		std::vector<u8> dst(copy_sample_size);
+
+		// Warm up caches and page mappings before measuring
+		std::memcpy(dst.data(), src.data(), copy_sample_size);
+
+		u64 start = rsx::nclock();
+
+		for (u32 i = 0; i < copy_iterations; i++)
 		{
-			std::memcpy(dst, src.data(), length);
+			std::memcpy(dst.data(), src.data(), copy_sample_size);
 		}
-		else
+
+		const u64 copy_time = std::max<u64>(rsx::nclock() - start, 1);
+
+		start = rsx::nclock();
+
+		for (u32 i = 0; i < enqueue_iterations; i++)
 		{
-			m_thread->m_enqueued_count++;
-			m_thread->m_work_queue.push(dst, src, length);
+			next_worker().enqueue(dst.data() + (i % (copy_sample_size / enqueue_sample_size)) * enqueue_sample_size, src.data(), enqueue_sample_size);
 		}
+
+		const u64 enqueue_time = rsx::nclock() - start;
+
+		// The buffers must outlive the queued transfers
+		sync();
+
+		const f64 bytes_per_ns = static_cast<f64>(copy_sample_size) * copy_iterations / copy_time;
+		const f64 enqueue_ns = static_cast<f64>(enqueue_time) / enqueue_iterations;
+		const u32 crossover = static_cast<u32>(std::min(bytes_per_ns * enqueue_ns, 65536.));
+
+		max_immediate_transfer_size = std::clamp<u32>(utils::align(crossover, 512), 512, 65536);
+
+		rsx_log.notice("DMA offload calibration: memcpy %.2f GB/s, enqueue %.1fns", bytes_per_ns, enqueue_ns);
 	}
 
+	dma_manager::offload_thread& dma_manager::next_worker() const
+	{
+		return *m_workers[m_next_worker++ % m_workers.size()];
+	}
+
+	dma_manager::offload_thread* dma_manager::get_current_worker() const
+	{
+		if (auto cpu = thread_ctrl::get_current())
+		{
+			for (const auto& worker : m_workers)
+			{
+				if (worker->current_thread_ == cpu)
+				{
+					return worker.get();
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	// General transport
 	void dma_manager::copy(void *dst, void *src, u32 length) const
 	{
 		if (length <= max_immediate_transfer_size || !g_cfg.video.multithreaded_rsx)
@@ -118,8 +244,7 @@ namespace rsx
 		}
 		else
 		{
-			m_thread->m_enqueued_count++;
-			m_thread->m_work_queue.push(dst, src, length);
+			next_worker().enqueue(dst, src, length);
 		}
 	}
 
@@ -133,8 +258,7 @@ namespace rsx
 		}
 		else
 		{
-			m_thread->m_enqueued_count++;
-			m_thread->m_work_queue.push(dst, primitive, count);
+			next_worker().enqueue(dst, primitive, count);
 		}
 	}
 
@@ -143,31 +267,47 @@ namespace rsx
 	{
 		ensure(g_cfg.video.multithreaded_rsx);
 
-		m_thread->m_enqueued_count++;
-		m_thread->m_work_queue.push(request_code, args);
+		std::lock_guard lock(m_fence_lock);
+		const u64 fence_id = ++m_fence_id;
+
+		// Fences are pushed in order under the lock so that each worker observes them monotonically
+		for (usz i = 1; i < m_workers.size(); i++)
+		{
+			m_workers[i]->enqueue(fence_id);
+		}
+
+		m_workers[0]->enqueue(request_code, args, fence_id);
 	}
 
 	// Synchronization
 	bool dma_manager::is_current_thread() const
 	{
-		if (auto cpu = thread_ctrl::get_current())
-		{
-			return m_thread->current_thread_ == cpu;
-		}
-
-		return false;
+		return get_current_worker() != nullptr;
 	}
 
 	bool dma_manager::sync() const
 	{
-		auto& _thr = *m_thread;
+		const auto all_idle = [this]()
+		{
+			for (const auto& worker : m_workers)
+			{
+				if (!worker->is_idle())
+				{
+					return false;
+				}
+			}
 
-		if (_thr.m_enqueued_count.load() <= _thr.m_processed_count.load()) [[likely]]
+			return true;
+		};
+
+		if (all_idle()) [[likely]]
 		{
 			// Nothing to do
 			return true;
 		}
 
+		rsx::timeline::scoped_event stall_event(rsx::timeline::event_type::dma_stall);
+
 		if (auto rsxthr = get_current_renderer(); rsxthr->is_current_thread())
 		{
 			if (m_mem_fault_flag)
@@ -176,7 +316,7 @@ namespace rsx
 				return false;
 			}
 
-			while (_thr.m_enqueued_count.load() > _thr.m_processed_count.load())
+			while (!all_idle())
 			{
 				rsxthr->on_semaphore_acquire_wait();
 				utils::pause();
@@ -184,7 +324,7 @@ namespace rsx
 		}
 		else
 		{
-			while (_thr.m_enqueued_count.load() > _thr.m_processed_count.load())
+			while (!all_idle())
 				utils::pause();
 		}
 
@@ -194,12 +334,17 @@ namespace rsx
 	void dma_manager::join()
 	{
 		sync();
-		*m_thread = thread_state::aborting;
+
+		for (auto& worker : m_workers)
+		{
+			*worker = thread_state::aborting;
+		}
 	}
 
 	void dma_manager::set_mem_fault_flag()
 	{
 		ensure(is_current_thread()); // "Access denied"
+		m_fault_lock.lock();
 		m_mem_fault_flag.release(true);
 	}
 
@@ -207,12 +352,13 @@ namespace rsx
 	{
 		ensure(is_current_thread()); // "Access denied"
 		m_mem_fault_flag.release(false);
+		m_fault_lock.unlock();
 	}
 
 	// Fault recovery
 	utils::address_range dma_manager::get_fault_range(bool writing) const
 	{
-		const auto m_current_job = ensure(m_thread->m_current_job);
+		const auto m_current_job = ensure(ensure(get_current_worker())->m_current_job);
 
 		void *address = nullptr;
 		u32 range = m_current_job->length;
@@ -222,10 +368,6 @@ namespace rsx
 		case raw_copy:
 			address = (writing) ? m_current_job->dst : m_current_job->src;
 			break;
-		case vector_copy:
-			ensure(writing);
-			address = m_current_job->dst;
-			break;
 		case index_emulate:
 			ensure(writing);
 			address = m_current_job->dst;
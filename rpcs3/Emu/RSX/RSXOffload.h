@@ -2,8 +2,10 @@
 
 #include "util/types.hpp"
 #include "Utilities/address_range.h"
+#include "Utilities/mutex.h"
 #include "gcm_enums.h"
 
+#include <memory>
 #include <vector>
 
 template <typename T>
@@ -16,57 +18,76 @@ namespace rsx
 		enum op
 		{
 			raw_copy = 0,
-			vector_copy = 1,
 			index_emulate = 2,
-			callback = 3
+			callback = 3,
+			fence = 4
 		};
 
 		struct transport_packet
 		{
 			op type{};
-			std::vector<u8> opt_storage{};
 			void* src{};
 			void* dst{};
 			u32 length{};
 			u32 aux_param0{};
 			u32 aux_param1{};
+			u64 fence_id{};
 
 			transport_packet(void *_dst, void *_src, u32 len)
 				: type(op::raw_copy), src(_src), dst(_dst), length(len)
 			{}
 
-			transport_packet(void *_dst, std::vector<u8>& _src, u32 len)
-				: type(op::vector_copy), opt_storage(std::move(_src)), dst(_dst), length(len)
-			{}
-
 			transport_packet(void *_dst, rsx::primitive_type prim, u32 len)
 				: type(op::index_emulate), dst(_dst), length(len), aux_param0(static_cast<u8>(prim))
 			{}
 
-			transport_packet(u32 command, void* args)
-				: type(op::callback), src(args), aux_param0(command)
+			transport_packet(u32 command, void* args, u64 fence)
+				: type(op::callback), src(args), aux_param0(command), fence_id(fence)
+			{}
+
+			transport_packet(u64 fence)
+				: type(op::fence), fence_id(fence)
 			{}
 
 			transport_packet(const transport_packet&) = delete;
 			transport_packet& operator=(const transport_packet&) = delete;
 		};
 
+	public:
+		static constexpr u32 max_workers = 8;
+
+	private:
 		atomic_t<bool> m_mem_fault_flag = false;
 
+		// Serializes memory faults raised by different workers, the renderer can only service one at a time
+		shared_mutex m_fault_lock;
+
 		struct offload_thread;
-		std::shared_ptr<named_thread<offload_thread>> m_thread;
+		std::vector<std::shared_ptr<named_thread<offload_thread>>> m_workers;
+
+		// Transfers are distributed round-robin, callbacks always run on the first worker
+		mutable atomic_t<u32> m_next_worker = 0;
+
+		// Callbacks are ordered after every transfer queued before them using fences
+		shared_mutex m_fence_lock;
+		u64 m_fence_id = 0;
+
+		// Transfers up to this size are cheaper to do inline than to queue
+		// Measured on startup unless overridden in the configuration
+		u32 max_immediate_transfer_size = 3584;
 
-		// TODO: Improved benchmarks here; value determined by profiling on a Ryzen CPU, rounded to the nearest 512 bytes
-		const u32 max_immediate_transfer_size = 3584;
+		offload_thread* get_current_worker() const;
+		offload_thread& next_worker() const;
+		void calibrate();
 
 	public:
-		dma_manager() = default;
+		dma_manager();
+		~dma_manager();
 
 		// initialization
 		void init();
 
 		// General tranport
-		void copy(void *dst, std::vector<u8>& src, u32 length) const;
 		void copy(void *dst, void *src, u32 length) const;
 
 		// Vertex utilities
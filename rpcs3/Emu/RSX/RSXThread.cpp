@@ -11,6 +11,7 @@
 #include "Common/texture_cache.h"
 #include "Common/surface_store.h"
 #include "Common/time.hpp"
+#include "Common/timeline.h"
 #include "Core/RSXReservationLock.hpp"
 #include "Core/RSXEngLock.hpp"
 #include "rsx_methods.h"
@@ -43,6 +44,7 @@ class GSRender;
 atomic_t<bool> g_user_asked_for_recording = false;
 atomic_t<bool> g_user_asked_for_screenshot = false;
 atomic_t<bool> g_user_asked_for_frame_capture = false;
+atomic_t<bool> g_user_asked_for_timeline_dump = false;
 atomic_t<bool> g_disable_frame_limit = false;
 rsx::frame_trace_data frame_debug;
 rsx::frame_capture_data frame_capture;
@@ -648,6 +650,9 @@ namespace rsx
 		m_graphics_state |= pipeline_state::all_dirty;
 
 		g_user_asked_for_frame_capture = false;
+		g_user_asked_for_timeline_dump = false;
+
+		rsx::timeline::g_enabled = g_cfg.video.record_frame_timeline.get();
 
 		if (g_cfg.misc.use_native_interface && (g_cfg.video.renderer == video_renderer::opengl || g_cfg.video.renderer == video_renderer::vulkan))
 		{
@@ -742,6 +747,11 @@ namespace rsx
 		}
 
 		in_begin_end = true;
+
+		if (rsx::timeline::enabled())
+		{
+			m_draw_begin_timestamp = rsx::nclock();
+		}
 	}
 
 	void thread::append_to_push_buffer(u32 attribute, u32 size, u32 subreg_index, vertex_base_type type, u32 value)
@@ -787,6 +797,12 @@ namespace rsx
 		in_begin_end = false;
 		m_frame_stats.draw_calls++;
 
+		if (m_draw_begin_timestamp)
+		{
+			rsx::timeline::record(rsx::timeline::event_type::draw_batch, m_draw_begin_timestamp, rsx::nclock(), method_registers.current_draw_clause.pass_count());
+			m_draw_begin_timestamp = 0;
+		}
+
 		method_registers.current_draw_clause.post_execute_cleanup();
 
 		m_graphics_state |= rsx::pipeline_state::framebuffer_reads_dirty;
@@ -905,6 +921,8 @@ namespace rsx
 
 		if (!serialized) method_registers.init();
 
+		m_frame_arena.make_current();
+
 		rsx::overlays::reset_performance_overlay();
 		rsx::overlays::reset_debug_overlay();
 
@@ -1125,6 +1143,31 @@ namespace rsx
 		g_fxo->get<rsx::dma_manager>().join();
 		g_fxo->get<vblank_thread>() = thread_state::finished;
 		state += cpu_flag::exit;
+
+		if (const auto arena_stats = m_frame_arena.take_statistics(); arena_stats.peak)
+		{
+			rsx_log.notice("Frame arena: peak usage of %uK per frame, %u heap fallbacks, %u deferred resets",
+				arena_stats.peak / 1024, m_frame_arena.get_total_fallback_count(), m_frame_arena.get_deferred_reset_count());
+		}
+
+		if (const auto analysis_stats = m_program_analysis_cache.get_total_statistics(); analysis_stats.lookups())
+		{
+			rsx_log.notice("Program analysis cache: %u/%u vertex and %u/%u fragment program hits",
+				analysis_stats.vertex_hits, analysis_stats.vertex_hits + analysis_stats.vertex_misses,
+				analysis_stats.fragment_hits, analysis_stats.fragment_hits + analysis_stats.fragment_misses);
+		}
+
+		if (const auto& flattening_stats = m_flattener.get_statistics(); flattening_stats.flattened_frames)
+		{
+			rsx_log.notice("FIFO flattening: %u of %u draws merged, active for %u of %u frames",
+				flattening_stats.merged_count, flattening_stats.draw_count, flattening_stats.flattened_frames, flattening_stats.frames);
+
+			for (const auto& record : m_flattener.get_decision_history())
+			{
+				rsx_log.notice("FIFO flattening %s at frame %u (%u draws, %u merged)",
+					FIFO::flattening_helper::get_decision_name(record.result), record.frame, record.draw_count, record.merged_count);
+			}
+		}
 	}
 
 	void thread::fill_scale_offset_data(void *buffer, bool flip_y) const
@@ -1196,6 +1239,17 @@ namespace rsx
 		memcpy(buffer, data_block, 2 * 8 * sizeof(u32));
 	}
 
+	void thread::fill_vertex_env_data(void *buffer) const
+	{
+		auto buf = static_cast<u8*>(buffer);
+		fill_scale_offset_data(buf, false);
+		fill_user_clip_data(buf + 64);
+		*(reinterpret_cast<u32*>(buf + 128)) = rsx::method_registers.transform_branch_bits();
+		*(reinterpret_cast<f32*>(buf + 132)) = rsx::method_registers.point_size() * rsx::get_resolution_scale();
+		*(reinterpret_cast<f32*>(buf + 136)) = rsx::method_registers.clip_min();
+		*(reinterpret_cast<f32*>(buf + 140)) = rsx::method_registers.clip_max();
+	}
+
 	/**
 	* Fill buffer with vertex program constants.
 	* Buffer must be at least 512 float4 wide.
@@ -1637,7 +1691,7 @@ namespace rsx
 			// Check for size fit and attempt to correct incorrect inputs.
 			// BLUS30072 is misconfigured here and renders fine on PS3. The width fails to account for AA being active in that engine.
 			u16 corrected_width = umax;
-			std::vector<u32*> pitch_fixups;
+			rsx::frame_vector<u32*> pitch_fixups;
 
 			if (!depth_buffer_unused)
 			{
@@ -2096,8 +2150,9 @@ namespace rsx
 		const auto [program_offset, program_location] = method_registers.shader_program_address();
 		const auto prev_textures_reference_mask = current_fp_metadata.referenced_textures_mask;
 
-		auto data_ptr = vm::base(rsx::get_address(program_offset, program_location));
-		current_fp_metadata = program_hash_util::fragment_program_utils::analyse_fragment_program(data_ptr);
+		const u32 program_address = rsx::get_address(program_offset, program_location);
+		auto data_ptr = vm::base(program_address);
+		current_fp_metadata = m_program_analysis_cache.analyse_fragment_program(data_ptr, program_address);
 
 		current_fragment_program.data = (static_cast<u8*>(data_ptr) + current_fp_metadata.program_start_offset);
 		current_fragment_program.offset = program_offset + current_fp_metadata.program_start_offset;
@@ -2146,7 +2201,7 @@ namespace rsx
 		current_vertex_program.data.reserve(512 * 4);
 		current_vertex_program.jump_table.clear();
 
-		current_vp_metadata = program_hash_util::vertex_program_utils::analyse_vertex_program
+		current_vp_metadata = m_program_analysis_cache.analyse_vertex_program
 		(
 			method_registers.transform_program.data(),  // Input raw block
 			transform_program_start,                    // Address of entry point
@@ -2939,6 +2994,136 @@ namespace rsx
 		}
 	}
 
+	bool thread::update_vertex_layout(vertex_input_layout& layout, u32 sub_index)
+	{
+		auto& draw_call = rsx::method_registers.current_draw_clause;
+		const rsx::flags32_t vertex_state_mask = rsx::vertex_base_changed | rsx::vertex_arrays_changed;
+		const rsx::flags32_t vertex_state = (sub_index == 0) ? rsx::vertex_arrays_changed : draw_call.execute_pipeline_dependencies() & vertex_state_mask;
+
+		if (vertex_state & rsx::vertex_arrays_changed)
+		{
+			analyse_inputs_interleaved(layout);
+		}
+		else if (vertex_state & rsx::vertex_base_changed)
+		{
+			// Rebase vertex bases instead of
+			for (auto& info : layout.interleaved_blocks)
+			{
+				info->vertex_range.second = 0;
+				const auto vertex_base_offset = rsx::method_registers.vertex_data_base_offset();
+				info->real_offset_address = rsx::get_address(rsx::get_vertex_offset_from_base(vertex_base_offset, info->base_offset), info->memory_location);
+			}
+		}
+		else
+		{
+			// Discard cached results
+			for (auto& info : layout.interleaved_blocks)
+			{
+				info->vertex_range.second = 0;
+			}
+		}
+
+		if (vertex_state && !layout.validate())
+		{
+			// No vertex inputs enabled
+			// Execute remainining pipeline barriers with NOP draw
+			do
+			{
+				draw_call.execute_pipeline_dependencies();
+			}
+			while (draw_call.next());
+
+			draw_call.end();
+			return false;
+		}
+
+		return true;
+	}
+
+	draw_index_info thread::write_draw_index_data(const vertex_input_layout& layout, const std::function<std::pair<void*, u32>(u32)>& alloc, bool(*is_native)(primitive_type))
+	{
+		const auto& draw_call = rsx::method_registers.current_draw_clause;
+
+		// Emulated buffer for non-native primitives, indices only range from 0->original_vertex_array_length
+		const auto write_emulated_indices = [&](u32 vertex_count) -> std::pair<u32, u32>
+		{
+			const u32 element_count = get_index_count(draw_call.primitive, vertex_count);
+			const auto mapping = alloc(element_count * sizeof(u16));
+
+			write_index_array_for_non_indexed_non_native_primitive_to_buffer(static_cast<char*>(mapping.first), draw_call.primitive, vertex_count);
+			return { element_count, mapping.second };
+		};
+
+		switch (draw_call.command)
+		{
+		case rsx::draw_command::indexed:
+		{
+			const rsx::index_array_type type = draw_call.is_immediate_draw ?
+				rsx::index_array_type::u32 :
+				rsx::method_registers.index_type();
+
+			const u32 type_size = get_index_type_size(type);
+			const u32 vertex_count = draw_call.get_elements_count();
+			u32 index_count = vertex_count;
+
+			if (!is_native(draw_call.primitive))
+				index_count = get_index_count(draw_call.primitive, vertex_count);
+
+			const u32 max_size = index_count * type_size;
+			const auto mapping = alloc(max_size);
+
+			u32 min_index, max_index;
+			std::tie(min_index, max_index, index_count) = write_index_array_data_to_buffer(
+				{ static_cast<std::byte*>(mapping.first), max_size },
+				get_raw_index_array(draw_call), type,
+				draw_call.primitive,
+				rsx::method_registers.restart_index_enabled(),
+				rsx::method_registers.restart_index(),
+				[is_native](auto prim) { return !is_native(prim); });
+
+			if (min_index >= max_index)
+			{
+				// Empty set, do not draw
+				return { false, 0, 0, 0, 0, std::make_pair(type, mapping.second) };
+			}
+
+			// Prefer only reading the vertices that are referenced in the index buffer itself
+			// Offset data source by min_index verts, but also notify the shader to offset the vertexID (important for modulo op)
+			const auto index_offset = rsx::method_registers.vertex_data_base_index();
+			return { true, min_index, max_index, index_count, index_offset, std::make_pair(type, mapping.second) };
+		}
+		case rsx::draw_command::inlined_array:
+		{
+			const auto stream_length = draw_call.inline_vertex_array.size();
+			const u32 vertex_count = u32(stream_length * sizeof(u32)) / layout.interleaved_blocks[0]->attribute_stride;
+
+			if (!is_native(draw_call.primitive))
+			{
+				const auto [index_count, offset] = write_emulated_indices(vertex_count);
+				return { false, 0, vertex_count, index_count, 0, std::make_pair(rsx::index_array_type::u16, offset) };
+			}
+
+			return { false, 0, vertex_count, vertex_count, 0, std::nullopt };
+		}
+		case rsx::draw_command::array:
+		{
+			const u32 vertex_count = draw_call.get_elements_count();
+			const u32 min_index = draw_call.min_index();
+			const u32 max_index = (min_index + vertex_count) - 1;
+
+			if (!is_native(draw_call.primitive))
+			{
+				const auto [index_count, offset] = write_emulated_indices(vertex_count);
+				return { false, min_index, max_index, index_count, 0, std::make_pair(rsx::index_array_type::u16, offset) };
+			}
+
+			return { false, min_index, max_index, vertex_count, 0, std::nullopt };
+		}
+		default:
+			fmt::throw_exception("ill-formed draw command");
+		}
+	}
+
 	void thread::flip(const display_flip_info_t& info)
 	{
 		m_eng_interrupt_mask.clear(rsx::display_interrupt);
@@ -3438,6 +3623,8 @@ namespace rsx
 					}
 				}
 
+				iomap_table.version++;
+
 				for (u32 i = 0; i < std::size(unmap_status); i++)
 				{
 					// TODO: Check order when sending multiple events
@@ -3631,6 +3818,18 @@ namespace rsx
 			}
 		}
 
+		if (g_user_asked_for_timeline_dump.exchange(false))
+		{
+			if (rsx::timeline::enabled())
+			{
+				rsx::timeline::dump(fs::get_config_dir() + "captures/" + Emu.GetTitleID() + "_" + date_time::current_time_narrow() + "_timeline.json");
+			}
+			else
+			{
+				rsx_log.error("Frame timeline recording is disabled. Enable 'Record Frame Timeline' in the video settings first.");
+			}
+		}
+
 		if (zcull_ctrl->has_pending())
 		{
 			// NOTE: This is a workaround for buggy games.
@@ -3640,6 +3839,26 @@ namespace rsx
 			zcull_ctrl->clear(this, CELL_GCM_ZPASS_PIXEL_CNT | CELL_GCM_ZCULL_STATS);
 		}
 
+		const auto zcull_stats = zcull_ctrl->take_statistics();
+		m_frame_stats.zcull_sync_count = zcull_stats.sync_count;
+		m_frame_stats.zcull_stall_time = zcull_stats.stall_time;
+		m_frame_stats.zcull_report_count = zcull_stats.report_count;
+		m_frame_stats.zcull_write_count = zcull_stats.write_count;
+
+		const auto analysis_stats = m_program_analysis_cache.take_statistics();
+		m_frame_stats.program_analysis_count = static_cast<u32>(analysis_stats.lookups());
+		m_frame_stats.program_analysis_hits = static_cast<u32>(analysis_stats.hits());
+
+		const auto arena_stats = m_frame_arena.take_statistics();
+		m_frame_stats.frame_arena_used = arena_stats.used;
+		m_frame_stats.frame_arena_peak = arena_stats.peak;
+		m_frame_stats.frame_arena_fallbacks = arena_stats.fallback_count;
+
+		m_frame_stats.merged_draw_calls = m_flattener.get_merged_count();
+		m_frame_stats.flattening_enabled = m_flattener.is_enabled();
+		rsx::timeline::record_instant(rsx::timeline::event_type::draw_statistics,
+			(u64{m_frame_stats.merged_draw_calls} << 32) | (m_frame_stats.draw_calls + m_frame_stats.merged_draw_calls));
+
 		// Save current state
 		m_queued_flip.stats = m_frame_stats;
 		m_queued_flip.push(buffer);
@@ -3684,9 +3903,16 @@ namespace rsx
 			thread_ctrl::wait_for(30'000);
 		}
 
+		const auto benchmark = g_fxo->try_get<rsx::replay_benchmark>();
+
+		if (benchmark) [[unlikely]]
+		{
+			benchmark->on_frame_end(m_frame_stats, performance_counters.idle_time);
+		}
+
 		// Reset current stats
 		m_frame_stats = {};
-		m_profiler.enabled = !!g_cfg.video.overlay;
+		m_profiler.enabled = g_cfg.video.overlay || benchmark;
 	}
 
 	bool thread::request_emu_flip(u32 buffer)
@@ -3709,6 +3935,8 @@ namespace rsx
 
 			m_eng_interrupt_mask |= rsx::display_interrupt;
 
+			rsx::timeline::record_instant(rsx::timeline::event_type::ppu_flip_request, buffer);
+
 			if (state & cpu_flag::exit)
 			{
 				// Resubmit possibly-ignored flip on savestate load
@@ -3807,7 +4035,13 @@ namespace rsx
 		m_queued_flip.in_progress = true;
 		m_queued_flip.skip_frame |= g_cfg.video.disable_video_output && !g_cfg.video.perf_overlay.perf_overlay_enabled;
 
-		flip(m_queued_flip);
+		{
+			rsx::timeline::scoped_event flip_event(rsx::timeline::event_type::flip, buffer);
+			flip(m_queued_flip);
+		}
+
+		// Temporaries of the presented frame are gone by now
+		m_frame_arena.reset();
 
 		last_guest_flip_timestamp = rsx::uclock() - 1000000;
 		flip_status = CELL_GCM_DISPLAY_FLIP_STATUS_DONE;
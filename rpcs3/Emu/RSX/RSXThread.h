@@ -14,6 +14,7 @@
 #include "RSXZCULL.h"
 #include "rsx_utils.h"
 #include "Common/bitfield.hpp"
+#include "Common/frame_arena.h"
 #include "Common/profiling_timer.hpp"
 #include "Common/texture_cache_types.h"
 #include "Program/RSXVertexProgram.h"
@@ -34,6 +35,7 @@
 #include "Core/RSXVertexTypes.h"
 
 extern atomic_t<bool> g_user_asked_for_frame_capture;
+extern atomic_t<bool> g_user_asked_for_timeline_dump;
 extern atomic_t<bool> g_disable_frame_limit;
 extern rsx::frame_trace_data frame_debug;
 extern rsx::frame_capture_data frame_capture;
@@ -175,6 +177,8 @@ namespace rsx
 		std::vector<std::pair<u32, u32>> dump_callstack_list() const override;
 		std::string dump_misc() const override;
 
+		friend class FIFO::FIFO_control;
+
 	protected:
 		FIFO::flattening_helper m_flattener;
 		u32 fifo_ret_addr = RSX_CALL_STACK_EMPTY;
@@ -201,6 +205,9 @@ namespace rsx
 		rsx::profiling_timer m_profiler;
 		frame_statistics_t m_frame_stats;
 
+		// Scratch memory for temporaries of the texture and surface caches, rewound after each flip
+		rsx::frame_arena m_frame_arena;
+
 		// Savestates related
 		u32 m_pause_after_x_flips = 0;
 
@@ -238,6 +245,7 @@ namespace rsx
 			atomic_t<u64> idle_time{ 0 };  // Time spent idling in microseconds
 			u64 last_update_timestamp = 0; // Timestamp of last load update
 			u64 FIFO_idle_timestamp = 0;   // Timestamp of when FIFO queue becomes idle
+			u64 FIFO_busy_timestamp = 0;   // Timestamp of when FIFO queue started running, in nanoseconds (timeline only)
 			FIFO::state state = FIFO::state::running;
 			u32 approximate_load = 0;
 			u32 sampled_frames = 0;
@@ -283,6 +291,7 @@ namespace rsx
 
 		program_hash_util::fragment_program_utils::fragment_program_metadata current_fp_metadata = {};
 		program_hash_util::vertex_program_utils::vertex_program_metadata current_vp_metadata = {};
+		program_hash_util::program_analysis_cache m_program_analysis_cache;
 
 		std::array<u32, 4> get_color_surface_addresses() const;
 		u32 get_zeta_surface_address() const;
@@ -334,6 +343,7 @@ namespace rsx
 		vm::ptr<void(u32)> queue_handler = vm::null;
 		atomic_t<u64> vblank_count{0};
 		bool capture_current_frame = false;
+		u64 m_draw_begin_timestamp = 0; // Timeline only, in nanoseconds
 
 		u64 vblank_at_flip = umax;
 		u64 flip_notification_count = 0;
@@ -374,6 +384,7 @@ namespace rsx
 		virtual void emit_geometry(u32) {}
 
 		void run_FIFO();
+		void record_fifo_drain();
 
 	public:
 		thread(const thread&) = delete;
@@ -449,6 +460,18 @@ namespace rsx
 		 */
 		void write_vertex_data_to_memory(const vertex_input_layout& layout, u32 first_vertex, u32 vertex_count, void *persistent_data, void *volatile_data);
 
+		/**
+		 * Refreshes the vertex inputs for the given subdraw of the current draw clause
+		 * Returns false if no vertex input is enabled, in which case the remaining subdraws are retired as NOP draws
+		 */
+		bool update_vertex_layout(vertex_input_layout& layout, u32 sub_index);
+
+		/**
+		 * Writes the index buffer of the current subdraw, expanding primitives the host cannot draw natively
+		 * alloc(size) returns the host pointer and heap offset of a new index allocation
+		 */
+		draw_index_info write_draw_index_data(const vertex_input_layout& layout, const std::function<std::pair<void*, u32>(u32)>& alloc, bool(*is_native)(primitive_type));
+
 		void evaluate_cpu_usage_reduction_limits();
 
 	private:
@@ -470,6 +493,12 @@ namespace rsx
 		 */
 		void fill_user_clip_data(void *buffer) const;
 
+		/**
+		 * Fill buffer with the 144 byte vertex environment block.
+		 * Scale offset matrix, user clip data, transform branch bits, point size and depth clip range
+		 */
+		void fill_vertex_env_data(void *buffer) const;
+
 		/**
 		* Fill buffer with vertex program constants.
 		* Relocation table allows to do a partial fill with only selected registers.
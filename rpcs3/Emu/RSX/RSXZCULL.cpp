@@ -2,11 +2,35 @@
 #include "Core/RSXEngLock.hpp"
 #include "Core/RSXReservationLock.hpp"
 #include "RSXThread.h"
+#include "Common/time.hpp"
+#include "Common/timeline.h"
 
 namespace rsx
 {
 	namespace reports
 	{
+		namespace
+		{
+			// Accounts time the RSX thread spends blocked waiting for report data
+			class sync_stall_scope
+			{
+				zcull_statistics& m_stats;
+				timeline::scoped_event m_event{ timeline::event_type::zcull_sync };
+				u64 m_start = rsx::uclock();
+
+			public:
+				sync_stall_scope(zcull_statistics& stats)
+					: m_stats(stats)
+				{}
+
+				~sync_stall_scope()
+				{
+					m_stats.sync_count++;
+					m_stats.stall_time += rsx::uclock() - m_start;
+				}
+			};
+		}
+
 		ZCULL_control::ZCULL_control()
 		{
 			for (auto& query : m_occlusion_query_data)
@@ -239,6 +263,7 @@ namespace rsx
 					rsx_log.error("Close to our death.");
 				}
 
+				sync_stall_scope stall(m_frame_statistics);
 				m_next_tsc = 0;
 				update(ptimer, m_pending_writes.front().sink);
 
@@ -318,10 +343,8 @@ namespace rsx
 			m_sync_tag = std::max(m_sync_tag, payload.query->sync_tag);
 		}
 
-		void ZCULL_control::write(vm::addr_t sink, u64 timestamp, u32 type, u32 value)
+		u32 ZCULL_control::get_report_value(u32 type, u32 value) const
 		{
-			ensure(sink);
-
 			auto scale_result = [](u32 value)
 			{
 				const auto scale = rsx::get_resolution_scale_percent();
@@ -351,22 +374,74 @@ namespace rsx
 				break;
 			}
 
-			rsx::reservation_lock<true> lock(sink, 16);
+			return value;
+		}
+
+		void ZCULL_control::write(vm::addr_t sink, u64 timestamp, u32 type, u32 value)
+		{
+			ensure(sink);
+
+			rsx::reservation_lock<true> lock(sink, sizeof(CellGcmReportData));
 			auto report = vm::get_super_ptr<atomic_t<CellGcmReportData>>(sink);
-			report->store({ timestamp, value, 0 });
+			report->store({ timestamp, get_report_value(type, value), 0 });
 		}
 
 		void ZCULL_control::write(queued_report_write* writer, u64 timestamp, u32 value)
 		{
-			write(writer->sink, timestamp, writer->type, value);
-			on_report_completed(writer->sink);
+			ensure(writer->sink);
+
+			// The value is resolved now since it depends on the current unit state
+			value = get_report_value(writer->type, value);
+			m_coalesced_writes.push_back({ writer->sink, timestamp, value, true });
 
 			for (auto& addr : writer->sink_alias)
 			{
-				write(addr, timestamp, writer->type, value);
+				m_coalesced_writes.push_back({ addr, timestamp, value, false });
 			}
 		}
 
+		void ZCULL_control::flush_coalesced_writes()
+		{
+			constexpr u32 report_size = sizeof(CellGcmReportData);
+
+			for (usz first = 0; first < m_coalesced_writes.size();)
+			{
+				// Reports are usually allocated sequentially, extend the run while sinks stay contiguous
+				usz last = first + 1;
+				while (last < m_coalesced_writes.size() &&
+					m_coalesced_writes[last].sink == m_coalesced_writes[last - 1].sink + report_size)
+				{
+					last++;
+				}
+
+				{
+					rsx::reservation_lock<true> lock(m_coalesced_writes[first].sink, static_cast<u32>(last - first) * report_size);
+
+					for (usz i = first; i < last; i++)
+					{
+						const auto& entry = m_coalesced_writes[i];
+						auto report = vm::get_super_ptr<atomic_t<CellGcmReportData>>(entry.sink);
+						report->store({ entry.timestamp, entry.value, 0 });
+					}
+				}
+
+				// Release page references only once the data is visible
+				for (usz i = first; i < last; i++)
+				{
+					if (m_coalesced_writes[i].owner)
+					{
+						on_report_completed(m_coalesced_writes[i].sink);
+					}
+				}
+
+				m_frame_statistics.write_count++;
+				first = last;
+			}
+
+			m_frame_statistics.report_count += ::size32(m_coalesced_writes);
+			m_coalesced_writes.clear();
+		}
+
 		void ZCULL_control::retire(::rsx::thread* ptimer, queued_report_write* writer, u32 result)
 		{
 			if (!writer->forwarder)
@@ -389,6 +464,7 @@ namespace rsx
 					// Eval was inserted while ZCULL was active but not enqueued to write to memory yet
 					// write(addr) -> enable_zpass_stats -> eval_condition -> write(addr)
 					// In this case, use what already exists in memory, not the current counter
+					flush_coalesced_writes();
 					eval_failed = (vm::_ref<CellGcmReportData>(writer->sink).value == 0u);
 				}
 
@@ -416,6 +492,8 @@ namespace rsx
 				return;
 			}
 
+			sync_stall_scope stall(m_frame_statistics);
+
 			// Quick reverse scan to push commands ahead of time
 			for (auto It = m_pending_writes.rbegin(); It != m_pending_writes.rend(); ++It)
 			{
@@ -468,6 +546,8 @@ namespace rsx
 				processed++;
 			}
 
+			flush_coalesced_writes();
+
 			if (!has_unclaimed)
 			{
 				ensure(processed == m_pending_writes.size());
@@ -616,6 +696,8 @@ namespace rsx
 				processed++;
 			}
 
+			flush_coalesced_writes();
+
 			if (processed)
 			{
 				auto remaining = m_pending_writes.size() - processed;
@@ -712,9 +794,13 @@ namespace rsx
 				}
 
 				// There can be multiple queries all writing to the same address, loop to flush all of them
-				while (query->pending)
+				if (query->pending)
 				{
-					update(ptimer, sync_address);
+					sync_stall_scope stall(m_frame_statistics);
+					while (query->pending)
+					{
+						update(ptimer, sync_address);
+					}
 				}
 				return result_none;
 			}
@@ -725,9 +811,13 @@ namespace rsx
 		flags32_t ZCULL_control::read_barrier(class ::rsx::thread* ptimer, u32 memory_address, occlusion_query_info* query)
 		{
 			// Called by cond render control. Internal RSX usage, do not disable optimizations
-			while (query->pending)
+			if (query->pending)
 			{
-				update(ptimer, memory_address);
+				sync_stall_scope stall(m_frame_statistics);
+				while (query->pending)
+				{
+					update(ptimer, memory_address);
+				}
 			}
 
 			return result_none;
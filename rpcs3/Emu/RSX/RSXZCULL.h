@@ -72,6 +72,14 @@ namespace rsx
 			void* other_params;
 		};
 
+		struct zcull_statistics
+		{
+			u32 sync_count;   // Hard syncs which had to wait for report data
+			u64 stall_time;   // Time spent inside hard syncs, in microseconds
+			u32 report_count; // Reports written to memory, including aliases
+			u32 write_count;  // Locked memory writes after coalescing adjacent reports
+		};
+
 		struct MMIO_page_data_t : public rsx::ref_counted
 		{
 			utils::protection prot = utils::protection::rw;
@@ -101,9 +109,22 @@ namespace rsx
 			atomic_t<s32> m_critical_reports_in_flight = { 0 };
 			shared_mutex m_pages_mutex;
 
+			struct coalesced_write
+			{
+				vm::addr_t sink;
+				u64 timestamp;
+				u32 value;
+				bool owner; // False for aliased copies of the report
+			};
+
+			// Report writes retired by the current sync point. Runs of adjacent sinks are written under a single lock.
+			std::vector<coalesced_write> m_coalesced_writes;
+			zcull_statistics m_frame_statistics{};
+
 			void on_report_enqueued(vm::addr_t address);
 			void on_report_completed(vm::addr_t address);
 			void disable_optimizations(class ::rsx::thread* ptimer, u32 location);
+			void flush_coalesced_writes();
 
 		protected:
 
@@ -142,8 +163,13 @@ namespace rsx
 			// Free a query slot in use
 			void free_query(occlusion_query_info* query);
 
+			// Converts the raw counter value into what the hardware would report
+			u32 get_report_value(u32 type, u32 value) const;
+
 			// Write report to memory
 			void write(vm::addr_t sink, u64 timestamp, u32 type, u32 value);
+
+			// Queue report for writing at the end of the current sync point
 			void write(queued_report_write* writer, u64 timestamp, u32 value);
 
 			// Retire operation
@@ -185,6 +211,9 @@ namespace rsx
 			// Check for pending writes
 			bool has_pending() const { return !m_pending_writes.empty(); }
 
+			// Returns sync statistics gathered since the last call
+			zcull_statistics take_statistics() { return std::exchange(m_frame_statistics, {}); }
+
 			// Search for query synchronized at address
 			query_search_result find_query(vm::addr_t sink_address, bool all);
 
@@ -706,43 +706,8 @@ void VKGSRender::emit_geometry(u32 sub_index)
 	auto &draw_call = rsx::method_registers.current_draw_clause;
 	m_profiler.start();
 
-	const rsx::flags32_t vertex_state_mask = rsx::vertex_base_changed | rsx::vertex_arrays_changed;
-	const rsx::flags32_t vertex_state = (sub_index == 0) ? rsx::vertex_arrays_changed : draw_call.execute_pipeline_dependencies() & vertex_state_mask;
-
-	if (vertex_state & rsx::vertex_arrays_changed)
-	{
-		analyse_inputs_interleaved(m_vertex_layout);
-	}
-	else if (vertex_state & rsx::vertex_base_changed)
-	{
-		// Rebase vertex bases instead of
-		for (auto& info : m_vertex_layout.interleaved_blocks)
-		{
-			info->vertex_range.second = 0;
-			const auto vertex_base_offset = rsx::method_registers.vertex_data_base_offset();
-			info->real_offset_address = rsx::get_address(rsx::get_vertex_offset_from_base(vertex_base_offset, info->base_offset), info->memory_location);
-		}
-	}
-	else
+	if (!update_vertex_layout(m_vertex_layout, sub_index))
 	{
-		// Discard cached results
-		for (auto& info : m_vertex_layout.interleaved_blocks)
-		{
-			info->vertex_range.second = 0;
-		}
-	}
-
-	if (vertex_state && !m_vertex_layout.validate())
-	{
-		// No vertex inputs enabled
-		// Execute remainining pipeline barriers with NOP draw
-		do
-		{
-			draw_call.execute_pipeline_dependencies();
-		}
-		while (draw_call.next());
-
-		draw_call.end();
 		return;
 	}
 
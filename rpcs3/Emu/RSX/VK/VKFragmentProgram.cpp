@@ -4,6 +4,9 @@
 #include "VKHelpers.h"
 #include "vkutils/device.h"
 #include "Emu/system_config.h"
+#include "Emu/IdManager.h"
+#include "Emu/RSX/Common/time.hpp"
+#include "../Program/program_source_cache.h"
 #include "../Program/GLSLCommon.h"
 #include "../GCM.h"
 
@@ -391,36 +394,67 @@ VKFragmentProgram::~VKFragmentProgram()
 
 void VKFragmentProgram::Decompile(const RSXFragmentProgram& prog)
 {
-	u32 size;
+	const auto pdev = vk::get_current_renderer();
+
+	// Everything the decompiler output depends on besides the program itself
+	u64 options_hash = rpcs3::hash64(rpcs3::fnv_seed, "VKFP"_u32);
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(g_cfg.video.shader_precision.get()));
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(g_cfg.video.antialiasing_level.get()));
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(vk::get_driver_vendor()));
+	options_hash = rpcs3::hash64(options_hash, pdev->get_shader_types_support().allow_float16);
+	options_hash = rpcs3::hash64(options_hash, pdev->get_formats_support().d24_unorm_s8);
+	options_hash = rpcs3::hash64(options_hash, rpcs3::hash_struct(vk::g_render_device->get_pipeline_binding_table()));
+
+	auto& source_cache = g_fxo->get<rsx::program_source_cache>();
+	const u64 cache_key = rsx::program_source_cache::get_key(prog, options_hash);
+	const u64 start = rsx::uclock();
+
 	std::string source;
-	VKFragmentDecompilerThread decompiler(source, parr, prog, size, *this);
+	utils::serial ar;
 
-	const auto pdev = vk::get_current_renderer();
-	if (g_cfg.video.shader_precision == gpu_preset_level::low)
+	if (source_cache.load(cache_key, ar))
 	{
-		decompiler.device_props.has_native_half_support = pdev->get_shader_types_support().allow_float16;
+		ar(source, FragmentConstantOffsetCache, output_color_masks, uniforms);
+		source_cache.on_restored(rsx::uclock() - start);
 	}
+	else
+	{
+		u32 size;
+		VKFragmentDecompilerThread decompiler(source, parr, prog, size, *this);
 
-	decompiler.device_props.emulate_depth_compare = !pdev->get_formats_support().d24_unorm_s8;
-	decompiler.device_props.has_low_precision_rounding = vk::get_driver_vendor() == vk::driver_vendor::NVIDIA;
-	decompiler.Task();
+		if (g_cfg.video.shader_precision == gpu_preset_level::low)
+		{
+			decompiler.device_props.has_native_half_support = pdev->get_shader_types_support().allow_float16;
+		}
 
-	shader.create(::glsl::program_domain::glsl_fragment_program, source);
+		decompiler.device_props.emulate_depth_compare = !pdev->get_formats_support().d24_unorm_s8;
+		decompiler.device_props.has_low_precision_rounding = vk::get_driver_vendor() == vk::driver_vendor::NVIDIA;
+		decompiler.Task();
 
-	for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
-	{
-		for (const ParamItem& PI : PT.items)
+		for (const ParamType& PT : decompiler.m_parr.params[PF_PARAM_UNIFORM])
 		{
-			if (PT.type == "sampler1D" ||
-				PT.type == "sampler2D" ||
-				PT.type == "sampler3D" ||
-				PT.type == "samplerCube")
-				continue;
+			for (const ParamItem& PI : PT.items)
+			{
+				if (PT.type == "sampler1D" ||
+					PT.type == "sampler2D" ||
+					PT.type == "sampler3D" ||
+					PT.type == "samplerCube")
+					continue;
+
+				usz offset = atoi(PI.name.c_str() + 2);
+				FragmentConstantOffsetCache.push_back(offset);
+			}
+		}
 
-			usz offset = atoi(PI.name.c_str() + 2);
-			FragmentConstantOffsetCache.push_back(offset);
+		if (source_cache.enabled())
+		{
+			ar(source, FragmentConstantOffsetCache, output_color_masks, uniforms);
 		}
+
+		source_cache.store(cache_key, ar, rsx::uclock() - start);
 	}
+
+	shader.create(::glsl::program_domain::glsl_fragment_program, source);
 }
 
 void VKFragmentProgram::Compile()
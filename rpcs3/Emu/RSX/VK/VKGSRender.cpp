@@ -702,6 +702,11 @@ VKGSRender::VKGSRender(utils::serial* ar) noexcept : GSRender(ar)
 		{
 			// Program was linked or queued for linking
 			m_shaders_cache->store(props, vp, fp);
+		},
+		[this](const vk::pipeline_props& props, const RSXVertexProgram& vp, const RSXFragmentProgram& fp)
+		{
+			// Cached program was requested for the first time this session
+			m_shaders_cache->touch(props, vp, fp);
 		}
 	);
 
@@ -1027,12 +1032,15 @@ bool VKGSRender::on_access_violation(u32 address, bool is_writing)
 		if (g_fxo->get<rsx::dma_manager>().is_current_thread())
 		{
 			// The offloader thread cannot handle flush requests
+			// Raising the flag first serializes faults coming from different offload workers
+			g_fxo->get<rsx::dma_manager>().set_mem_fault_flag();
+
+			// The previous fault owner only drops the lock once the deadlock state has been cleared
 			ensure(!(m_queue_status & flush_queue_state::deadlock));
 
 			m_offloader_fault_range = g_fxo->get<rsx::dma_manager>().get_fault_range(is_writing);
 			m_offloader_fault_cause = (is_writing) ? rsx::invalidation_cause::write : rsx::invalidation_cause::read;
 
-			g_fxo->get<rsx::dma_manager>().set_mem_fault_flag();
 			m_queue_status |= flush_queue_state::deadlock;
 			m_eng_interrupt_mask |= rsx::backend_interrupt;
 
@@ -1479,6 +1487,12 @@ void VKGSRender::on_init_thread()
 
 void VKGSRender::on_exit()
 {
+	if (m_shaders_cache)
+	{
+		// Pipelines still being warmed up in the background reference the program cache
+		m_shaders_cache->stop_background_compile();
+	}
+
 	GSRender::on_exit();
 	zcull_ctrl.release();
 }
@@ -2063,9 +2077,17 @@ bool VKGSRender::load_program()
 		vk::enter_uninterruptible();
 
 		// Load current program from cache
+		const u64 lookup_start = m_profiler.enabled ? rsx::nclock() : 0;
+
 		std::tie(m_program, m_vertex_prog, m_fragment_prog) = m_prog_buffer->get_graphics_pipeline(vertex_program, fragment_program, m_pipeline_properties,
 			shadermode != shader_mode::recompiler, true, m_pipeline_layout);
 
+		if (m_profiler.enabled)
+		{
+			m_frame_stats.program_lookup_time += rsx::nclock() - lookup_start;
+			m_frame_stats.program_lookup_count++;
+		}
+
 		vk::leave_uninterruptible();
 
 		if (m_prog_buffer->check_cache_missed())
@@ -2121,14 +2143,8 @@ void VKGSRender::load_program_env()
 
 		// Vertex state
 		const auto mem = m_vertex_env_ring_info.alloc<256>(256);
-		auto buf = static_cast<u8*>(m_vertex_env_ring_info.map(mem, 148));
-
-		fill_scale_offset_data(buf, false);
-		fill_user_clip_data(buf + 64);
-		*(reinterpret_cast<u32*>(buf + 128)) = rsx::method_registers.transform_branch_bits();
-		*(reinterpret_cast<f32*>(buf + 132)) = rsx::method_registers.point_size() * rsx::get_resolution_scale();
-		*(reinterpret_cast<f32*>(buf + 136)) = rsx::method_registers.clip_min();
-		*(reinterpret_cast<f32*>(buf + 140)) = rsx::method_registers.clip_max();
+		auto buf = m_vertex_env_ring_info.map(mem, 148);
+		fill_vertex_env_data(buf);
 
 		m_vertex_env_ring_info.unmap();
 		m_vertex_env_buffer_info = { m_vertex_env_ring_info.heap->value, mem, 144 };
@@ -818,10 +818,16 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 			const auto num_texture_upload_miss = m_texture_cache.get_texture_upload_misses_this_frame();
 			const auto texture_upload_miss_ratio = m_texture_cache.get_texture_upload_miss_percentage();
 			const auto texture_copies_ellided = m_texture_cache.get_texture_copies_ellided_this_frame();
+			const auto texture_memo_hits = m_texture_cache.get_texture_memo_hits_this_frame();
 			const auto vertex_cache_hit_count = (info.stats.vertex_cache_request_count - info.stats.vertex_cache_miss_count);
 			const auto vertex_cache_hit_ratio = info.stats.vertex_cache_request_count
 				? (vertex_cache_hit_count * 100) / info.stats.vertex_cache_request_count
 				: 0;
+			const auto program_analysis_hit_ratio = info.stats.program_analysis_count
+				? (info.stats.program_analysis_hits * 100) / info.stats.program_analysis_count
+				: 0;
+			const auto submitted_draw_calls = info.stats.draw_calls + info.stats.merged_draw_calls;
+			const auto register_writes_per_draw = submitted_draw_calls ? info.stats.register_writes / submitted_draw_calls : 0;
 
 			rsx::overlays::set_debug_overlay_text(fmt::format(
 				"RSX Load:                 %3d%%\n"
@@ -836,14 +842,22 @@ void VKGSRender::flip(const rsx::display_flip_info_t& info)
 				"Texture cache memory: %7dM\n"
 				"Temporary texture memory: %3dM\n"
 				"Flush requests: %13d  = %2d (%3d%%) hard faults, %2d unavoidable, %2d misprediction(s), %2d speculation(s)\n"
-				"Texture uploads: %12u (%u from CPU - %02u%%, %u copies avoided)\n"
-				"Vertex cache hits: %10u/%u (%u%%)",
+				"Texture uploads: %12u (%u from CPU - %02u%%, %u copies avoided, %u lock-free)\n"
+				"Vertex cache hits: %10u/%u (%u%%)\n"
+				"Program analysis hits: %6u/%u (%u%%)\n"
+				"FIFO flattening: %s, %u/%u draws merged, %u register writes/draw\n"
+				"ZCULL syncs: %u (%uus stalled), %u reports in %u writes\n"
+				"Frame arena: %uK used (peak %uK), %u fallbacks",
 				get_load(), info.stats.draw_calls, info.stats.submit_count, info.stats.setup_time, info.stats.vertex_upload_time,
 				info.stats.textures_upload_time, info.stats.draw_exec_time, info.stats.flip_time,
 				num_dirty_textures, texture_memory_size, tmp_texture_memory_size,
 				num_flushes, num_misses, cache_miss_ratio, num_unavoidable, num_mispredict, num_speculate,
-				num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio, texture_copies_ellided,
-				vertex_cache_hit_count, info.stats.vertex_cache_request_count, vertex_cache_hit_ratio)
+				num_texture_upload, num_texture_upload_miss, texture_upload_miss_ratio, texture_copies_ellided, texture_memo_hits,
+				vertex_cache_hit_count, info.stats.vertex_cache_request_count, vertex_cache_hit_ratio,
+				info.stats.program_analysis_hits, info.stats.program_analysis_count, program_analysis_hit_ratio,
+				info.stats.flattening_enabled ? "on" : "off", info.stats.merged_draw_calls, submitted_draw_calls, register_writes_per_draw,
+				info.stats.zcull_sync_count, info.stats.zcull_stall_time, info.stats.zcull_report_count, info.stats.zcull_write_count,
+				info.stats.frame_arena_used / 1024, info.stats.frame_arena_peak / 1024, info.stats.frame_arena_fallbacks)
 			);
 		}
 
@@ -68,9 +68,10 @@ namespace vk
 
 	struct program_cache : public program_state_cache<VKTraits>
 	{
-		program_cache(decompiler_callback_t callback)
+		program_cache(decompiler_callback_t callback, decompiler_callback_t usage_callback = {})
 		{
 			notify_pipeline_compiled = callback;
+			notify_pipeline_used = usage_callback;
 		}
 
 		u64 get_hash(const vk::pipeline_props& props)
@@ -2,6 +2,7 @@
 #include "VKProgramPipeline.h"
 #include "vkutils/descriptors.h"
 #include "vkutils/device.h"
+#include "util/serialization.hpp"
 #include <string>
 
 namespace vk
@@ -10,6 +11,11 @@ namespace vk
 	{
 		using namespace ::glsl;
 
+		void program_input::operator()(utils::serial& ar)
+		{
+			ar(domain, type, location, name);
+		}
+
 		void shader::create(::glsl::program_domain domain, const std::string& source)
 		{
 			type     = domain;
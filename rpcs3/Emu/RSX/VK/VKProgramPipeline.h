@@ -8,6 +8,11 @@
 #include <string>
 #include <vector>
 
+namespace utils
+{
+	struct serial;
+}
+
 namespace vk
 {
 	namespace glsl
@@ -47,6 +52,9 @@ namespace vk
 
 			u32 location;
 			std::string name;
+
+			// Only the decompiler-generated fields are persisted
+			void operator()(utils::serial& ar);
 		};
 
 		class shader
@@ -5,6 +5,9 @@
 #include "VKHelpers.h"
 #include "vkutils/device.h"
 #include "../Program/GLSLCommon.h"
+#include "../Program/program_source_cache.h"
+#include "Emu/IdManager.h"
+#include "Emu/RSX/Common/time.hpp"
 
 
 std::string VKVertexDecompilerThread::getFloatTypeName(usz elementCount)
@@ -348,12 +351,41 @@ VKVertexProgram::~VKVertexProgram()
 
 void VKVertexProgram::Decompile(const RSXVertexProgram& prog)
 {
+	// Everything the decompiler output depends on besides the program itself
+	u64 options_hash = rpcs3::hash64(rpcs3::fnv_seed, "VKVP"_u32);
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(g_cfg.video.shader_precision.get()));
+	options_hash = rpcs3::hash64(options_hash, static_cast<u32>(vk::get_driver_vendor()));
+	options_hash = rpcs3::hash64(options_hash, vk::emulate_conditional_rendering());
+	options_hash = rpcs3::hash64(options_hash, vk::g_render_device->get_shader_types_support().allow_float64);
+	options_hash = rpcs3::hash64(options_hash, rpcs3::hash_struct(vk::g_render_device->get_pipeline_binding_table()));
+
+	auto& source_cache = g_fxo->get<rsx::program_source_cache>();
+	const u64 cache_key = rsx::program_source_cache::get_key(prog, options_hash);
+	const u64 start = rsx::uclock();
+
 	std::string source;
-	VKVertexDecompilerThread decompiler(prog, source, parr, *this);
-	decompiler.Task();
+	utils::serial ar;
+
+	if (source_cache.load(cache_key, ar))
+	{
+		ar(source, has_indexed_constants, constant_ids, uniforms);
+		source_cache.on_restored(rsx::uclock() - start);
+	}
+	else
+	{
+		VKVertexDecompilerThread decompiler(prog, source, parr, *this);
+		decompiler.Task();
 
-	has_indexed_constants = decompiler.properties.has_indexed_constants;
-	constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+		has_indexed_constants = decompiler.properties.has_indexed_constants;
+		constant_ids = std::vector<u16>(decompiler.m_constant_ids.begin(), decompiler.m_constant_ids.end());
+
+		if (source_cache.enabled())
+		{
+			ar(source, has_indexed_constants, constant_ids, uniforms);
+		}
+
+		source_cache.store(cache_key, ar, rsx::uclock() - start);
+	}
 
 	shader.create(::glsl::program_domain::glsl_vertex_program, source);
 }
@@ -5,12 +5,16 @@
 #include "Common/bitfield.hpp"
 #include "Common/unordered_map.hpp"
 #include "Emu/System.h"
+#include "Emu/IdManager.h"
 #include "Emu/cache_utils.hpp"
 #include "Program/ProgramStateCache.h"
+#include "Program/pipeline_cache_file.h"
+#include "Program/program_source_cache.h"
 #include "Common/texture_cache_checker.h"
 #include "Overlays/Shaders/shader_loading_dialog.h"
 
 #include <chrono>
+#include <deque>
 
 #include "util/sysinfo.hpp"
 #include "util/fnv_hash.hpp"
@@ -62,13 +66,100 @@ namespace rsx
 		lf_fifo<std::unique_ptr<u8[]>, 100> fragment_program_data;
 
 		backend_storage& m_storage;
+		pipeline_cache_file m_pipeline_file;
+
+		// Pipelines deferred until after boot, compiled by low priority workers in order of hotness
+		struct background_queue
+		{
+			std::vector<pipeline_data> records;
+			std::unique_ptr<atomic_t<bool>[]> claimed;
+			std::unordered_multimap<u64, u32> by_programs; // Read-only once the workers are running
+			atomic_t<u32> next = 0;
+			atomic_t<u32> compiled = 0;
+			atomic_t<u32> prioritized = 0;
+
+			// Entries sharing programs with a pipeline the game just missed on are taken first
+			shared_mutex boost_lock;
+			std::deque<u32> boost_list;
+
+			std::vector<std::unique_ptr<named_thread<std::function<void()>>>> workers;
+		};
+
+		std::unique_ptr<background_queue> m_background;
 
 		static std::string get_message(u32 index, u32 processed, u32 entry_count)
 		{
 			return fmt::format("%s pipeline object %u of %u", index == 0 ? "Loading" : "Compiling", processed, entry_count);
 		}
 
-		void load_shaders(uint nb_workers, unpacked_type& unpacked, std::string& directory_path, std::vector<fs::dir_entry>& entries, u32 entry_count,
+		static u64 get_pipeline_key(const pipeline_data& data)
+		{
+			u64 state_hash = 0;
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl0);
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl1);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
+			state_hash ^= rpcs3::hash_base<u32>(data.vp_texture_dimensions);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
+			state_hash ^= rpcs3::hash_base<u32>(data.fp_texcoord_control);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.vp_multisampled_textures);
+			state_hash ^= rpcs3::hash_base<u16>(data.fp_multisampled_textures);
+
+			usz key = rpcs3::hash64(rpcs3::fnv_seed, data.vertex_program_hash);
+			key = rpcs3::hash64(key, data.fragment_program_hash);
+			key = rpcs3::hash64(key, data.pipeline_storage_hash);
+			key = rpcs3::hash64(key, state_hash);
+			return key;
+		}
+
+		static u64 get_programs_key(const pipeline_data& data)
+		{
+			return rpcs3::hash64(rpcs3::hash64(rpcs3::fnv_seed, data.vertex_program_hash), data.fragment_program_hash);
+		}
+
+		// Folds pipelines stored one per file by older builds into the packed cache
+		void import_legacy_pipelines(const std::string& directory_path)
+		{
+			std::vector<std::string> files;
+
+			for (auto&& tmp : fs::dir(directory_path))
+			{
+				if (!tmp.is_directory)
+				{
+					files.push_back(directory_path + "/" + tmp.name);
+				}
+			}
+
+			if (files.empty())
+			{
+				return;
+			}
+
+			u32 imported = 0;
+
+			for (const auto& filename : files)
+			{
+				fs::file f(filename);
+				pipeline_data pdata{};
+
+				if (f && f.size() == sizeof(pipeline_data) && f.read(pdata))
+				{
+					imported += m_pipeline_file.append(get_pipeline_key(pdata), &pdata);
+				}
+
+				f.close();
+				fs::remove_file(filename);
+			}
+
+			fs::remove_dir(directory_path);
+			rsx_log.notice("Imported %u of %u pipeline objects from %s into the packed pipeline cache", imported, files.size(), directory_path);
+		}
+
+		void load_shaders(uint nb_workers, unpacked_type& unpacked, const std::vector<pipeline_cache_file::index_entry>& entries, u32 entry_count,
 		    shader_loading_dialog* dlg)
 		{
 			atomic_t<u32> processed(0);
@@ -79,27 +170,14 @@ namespace rsx
 				// Processed is incremented before work starts in order to avoid two workers working on the same shader
 				while (((pos = processed++) < stop_at) && !Emu.IsStopped())
 				{
-					fs::dir_entry tmp = entries[pos];
-
-					const auto filename = directory_path + "/" + tmp.name;
-					fs::file f(filename);
+					pipeline_data pdata{};
 
-					if (!f)
+					if (!m_pipeline_file.read(entries[pos], &pdata))
 					{
 						// Unexpected error, but avoid crash
 						continue;
 					}
 
-					if (f.size() != sizeof(pipeline_data))
-					{
-						rsx_log.error("Removing cached pipeline object %s since it's not binary compatible with the current shader cache", tmp.name.c_str());
-						fs::remove_file(filename);
-						continue;
-					}
-
-					pipeline_data pdata{};
-					f.read(&pdata, f.size());
-
 					auto entry = unpack(pdata);
 
 					if (std::get<1>(entry).data.empty() || !std::get<2>(entry).ucode_length)
@@ -195,6 +273,117 @@ namespace rsx
 			}
 		}
 
+		template <typename... Args>
+		void start_background_compile(const std::vector<pipeline_cache_file::index_entry>& entries, uint nb_workers, Args&&... args)
+		{
+			auto queue = std::make_unique<background_queue>();
+			queue->records.reserve(entries.size());
+
+			for (const auto& entry : entries)
+			{
+				pipeline_data pdata{};
+
+				if (m_pipeline_file.read(entry, &pdata))
+				{
+					queue->by_programs.emplace(get_programs_key(pdata), ::size32(queue->records));
+					queue->records.push_back(pdata);
+				}
+			}
+
+			if (queue->records.empty())
+			{
+				return;
+			}
+
+			queue->claimed = std::make_unique<atomic_t<bool>[]>(queue->records.size());
+			m_background = std::move(queue);
+
+			rsx_log.notice("Compiling %u cached pipeline objects in the background using %u threads", m_background->records.size(), nb_workers);
+
+			for (uint i = 0; i < nb_workers; i++)
+			{
+				m_background->workers.emplace_back(std::make_unique<named_thread<std::function<void()>>>(fmt::format("RSX Shader Warm-up %u", i + 1), [this, args...]() mutable
+				{
+					// Pipelines requested by the game are compiled on other threads and must not be starved
+					thread_ctrl::set_native_priority(-1);
+					background_compile_worker(args...);
+				}));
+			}
+		}
+
+		template <typename... Args>
+		void background_compile_worker(Args&... args)
+		{
+			auto& queue = *m_background;
+			const u32 count = ::size32(queue.records);
+
+			while (thread_ctrl::state() != thread_state::aborting && !Emu.IsStopped())
+			{
+				u32 index = umax;
+
+				{
+					std::lock_guard lock(queue.boost_lock);
+
+					if (!queue.boost_list.empty())
+					{
+						index = queue.boost_list.front();
+						queue.boost_list.pop_front();
+					}
+				}
+
+				if (index == umax && (index = queue.next++) >= count)
+				{
+					// Everything left was claimed by other workers, including all prioritized entries
+					break;
+				}
+
+				if (queue.claimed[index].exchange(true))
+				{
+					continue;
+				}
+
+				auto entry = unpack(queue.records[index]);
+
+				if (std::get<1>(entry).data.empty() || !std::get<2>(entry).ucode_length)
+				{
+					continue;
+				}
+
+				m_storage.preload_programs(std::get<1>(entry), std::get<2>(entry));
+				m_storage.add_pipeline_entry(std::get<1>(entry), std::get<2>(entry), std::get<0>(entry), args...);
+				queue.compiled++;
+			}
+		}
+
+		// Moves pending pipelines built from the same programs as a missed pipeline to the front of the background queue
+		void prioritize(const pipeline_data& data)
+		{
+			auto& queue = *m_background;
+
+			if (queue.next >= queue.records.size())
+			{
+				return;
+			}
+
+			const auto [begin, end] = queue.by_programs.equal_range(get_programs_key(data));
+
+			if (begin == end)
+			{
+				return;
+			}
+
+			std::lock_guard lock(queue.boost_lock);
+
+			for (auto it = begin; it != end; ++it)
+			{
+				if (!queue.claimed[it->second])
+				{
+					queue.boost_list.push_back(it->second);
+					queue.prioritized++;
+				}
+			}
+		}
+
 	public:
 
 		shaders_cache(backend_storage& storage, std::string pipeline_class, std::string version_prefix_str = "v1")
@@ -211,6 +400,26 @@ namespace rsx
 			}
 		}
 
+		~shaders_cache()
+		{
+			stop_background_compile();
+		}
+
+		// Joins the background workers, must be called before the backend storage is torn down
+		// The queue itself is kept alive since pipeline compiler threads may still report misses
+		void stop_background_compile()
+		{
+			if (!m_background || m_background->workers.empty())
+			{
+				return;
+			}
+
+			m_background->workers.clear();
+
+			rsx_log.notice("Background shader compilation: %u of %u pipeline objects compiled, %u prioritized", m_background->compiled.load(),
+				m_background->records.size(), m_background->prioritized.load());
+		}
+
 		template <typename... Args>
 		void load(shader_loading_dialog* dlg, Args&& ...args)
 		{
@@ -219,61 +428,93 @@ namespace rsx
 				return;
 			}
 
-			std::string directory_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix;
+			// Decompiled sources are indexed up front so that pipeline loading can skip the decompilers
+			auto& source_cache = g_fxo->get<rsx::program_source_cache>();
+			fs::create_path(root_path + "/sources/" + pipeline_class_name);
+			source_cache.open(root_path + "/sources/" + pipeline_class_name + "/" + version_prefix);
+
+			const std::string directory_path = root_path + "/pipelines/" + pipeline_class_name;
 
-			fs::dir root = fs::dir(directory_path);
+			fs::create_path(directory_path);
+			fs::create_path(root_path + "/raw");
 
-			if (!root)
+			// All pipelines live in a single append-only pack, avoiding a directory scan over thousands of small files
+			if (!m_pipeline_file.open(directory_path + "/" + version_prefix, sizeof(pipeline_data)))
 			{
-				fs::create_path(directory_path);
-				fs::create_path(root_path + "/raw");
 				return;
 			}
 
-			std::vector<fs::dir_entry> entries;
+			import_legacy_pipelines(directory_path + "/" + version_prefix);
+
+			// Pipelines used most recently are compiled first
+			auto entries = m_pipeline_file.get_entries_by_hotness();
+
+			if (entries.empty())
+				return;
 
-			for (auto&& tmp : root)
+			const uint nb_workers = g_cfg.video.renderer == video_renderer::vulkan ? utils::get_thread_count() : 1;
+
+			// Only pipelines the last session needed shortly after boot are compiled up front, in the order they were first used
+			// Deferring the rest requires a backend able to build pipelines from any thread
+			std::vector<pipeline_cache_file::index_entry> deferred;
+
+			if (const u32 window_ms = g_cfg.video.shader_cache_boot_window * 1000; window_ms && nb_workers > 1)
 			{
-				if (tmp.is_directory)
-					continue;
+				const u32 last_session = m_pipeline_file.get_session() - 1;
+
+				const auto boot_end = std::stable_partition(entries.begin(), entries.end(), [&](const pipeline_cache_file::index_entry& e)
+				{
+					return e.last_session == last_session && e.first_use <= window_ms;
+				});
 
-				entries.push_back(tmp);
+				std::stable_sort(entries.begin(), boot_end, [](const pipeline_cache_file::index_entry& a, const pipeline_cache_file::index_entry& b)
+				{
+					return a.first_use < b.first_use;
+				});
+
+				deferred.assign(boot_end, entries.end());
+				entries.erase(boot_end, entries.end());
 			}
 
-			u32 entry_count = ::size32(entries);
+			if (u32 entry_count = ::size32(entries))
+			{
+				// Progress dialog
+				std::unique_ptr<shader_loading_dialog> fallback_dlg;
+				if (!dlg)
+				{
+					fallback_dlg = std::make_unique<shader_loading_dialog>();
+					dlg = fallback_dlg.get();
+				}
 
-			if (!entry_count)
-				return;
+				dlg->create("Preloading cached shaders from disk.\nPlease wait...", "Shader Compilation");
+				dlg->set_limit(0, entry_count);
+				dlg->set_limit(1, entry_count);
+				dlg->update_msg(0, get_message(0, 0, entry_count));
+				dlg->update_msg(1, get_message(1, 0, entry_count));
 
-			root.rewind();
+				// Preload everything needed to compile the shaders
+				unpacked_type unpacked;
 
-			// Progress dialog
-			std::unique_ptr<shader_loading_dialog> fallback_dlg;
-			if (!dlg)
-			{
-				fallback_dlg = std::make_unique<shader_loading_dialog>();
-				dlg = fallback_dlg.get();
-			}
+				load_shaders(nb_workers, unpacked, entries, entry_count, dlg);
 
-			dlg->create("Preloading cached shaders from disk.\nPlease wait...", "Shader Compilation");
-			dlg->set_limit(0, entry_count);
-			dlg->set_limit(1, entry_count);
-			dlg->update_msg(0, get_message(0, 0, entry_count));
-			dlg->update_msg(1, get_message(1, 0, entry_count));
+				// Account for any invalid entries
+				entry_count = unpacked.size();
 
-			// Preload everything needed to compile the shaders
-			unpacked_type unpacked;
-			uint nb_workers = g_cfg.video.renderer == video_renderer::vulkan ? utils::get_thread_count() : 1;
+				compile_shaders(nb_workers, unpacked, entry_count, dlg, std::forward<Args>(args)...);
 
-			load_shaders(nb_workers, unpacked, directory_path, entries, entry_count, dlg);
+				source_cache.report();
 
-			// Account for any invalid entries
-			entry_count = unpacked.size();
+				dlg->refresh();
+				dlg->close();
+			}
 
-			compile_shaders(nb_workers, unpacked, entry_count, dlg, std::forward<Args>(args)...);
+			// First use timestamps are relative to the game starting, not to the cache being opened
+			m_pipeline_file.start_session_clock();
 
-			dlg->refresh();
-			dlg->close();
+			if (!deferred.empty() && !Emu.IsStopped())
+			{
+				start_background_compile(deferred, std::max(1u, nb_workers / 2), std::forward<Args>(args)...);
+			}
 		}
 
 		void store(const pipeline_storage_type &pipeline, const RSXVertexProgram &vp, const RSXFragmentProgram &fp)
@@ -306,24 +547,29 @@ namespace rsx
 				fs::write_file(vp_name, fs::rewrite, vp.data);
 			}
 
-			u64 state_hash = 0;
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl0);
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_ctrl1);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_ctrl);
-			state_hash ^= rpcs3::hash_base<u32>(data.vp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texture_dimensions);
-			state_hash ^= rpcs3::hash_base<u32>(data.fp_texcoord_control);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_height);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_pixel_layout);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_lighting_flags);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_shadow_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_redirected_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.vp_multisampled_textures);
-			state_hash ^= rpcs3::hash_base<u16>(data.fp_multisampled_textures);
+			const u64 key = get_pipeline_key(data);
+
+			if (!m_pipeline_file.append(key, &data))
+			{
+				// Already cached (e.g. deferred entry built by the game before the background compiler got to it)
+				m_pipeline_file.touch(key);
+			}
+
+			if (m_background)
+			{
+				prioritize(data);
+			}
+		}
+
+		// Records that a cached pipeline was requested by the game in this session
+		void touch(const pipeline_storage_type &pipeline, const RSXVertexProgram &vp, const RSXFragmentProgram &fp)
+		{
+			if (!m_pipeline_file || vp.jump_table.size() > 32)
+			{
+				return;
+			}
 
-			const std::string pipeline_file_name = fmt::format("%llX+%llX+%llX+%llX.bin", data.vertex_program_hash, data.fragment_program_hash, data.pipeline_storage_hash, state_hash);
-			const std::string pipeline_path = root_path + "/pipelines/" + pipeline_class_name + "/" + version_prefix + "/" + pipeline_file_name;
-			fs::write_file(pipeline_path, fs::rewrite, &data, sizeof(data));
+			m_pipeline_file.touch(get_pipeline_key(pack(pipeline, vp, fp)));
 		}
 
 		RSXVertexProgram load_vp_raw(u64 program_hash) const
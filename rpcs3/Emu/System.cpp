@@ -724,7 +724,7 @@ std::string Emulator::GetBackgroundPicturePath() const
 	return path;
 }
 
-bool Emulator::BootRsxCapture(const std::string& path)
+bool Emulator::BootRsxCapture(const std::string& path, u32 benchmark_iterations, const std::string& benchmark_report)
 {
 	if (m_state != system_state::stopped)
 	{
@@ -788,9 +788,23 @@ bool Emulator::BootRsxCapture(const std::string& path)
 	Init();
 	g_cfg.video.disable_on_disk_shader_cache.set(true);
 
+	if (benchmark_iterations)
+	{
+		// Replay as fast as possible and exit once the report is written
+		g_cfg.video.frame_limit.set(frame_limit_type::none);
+		g_cfg.video.vsync.set(false);
+		g_cfg.misc.autoexit.set(true);
+	}
+
 	vm::init();
 	g_fxo->init(false);
 
+	if (benchmark_iterations)
+	{
+		sys_log.notice("Replaying rsx capture %u times in benchmark mode", benchmark_iterations);
+		g_fxo->init<rsx::replay_benchmark>(benchmark_iterations, benchmark_report);
+	}
+
 	// Initialize progress dialog
 	g_fxo->init<named_thread<progress_dialog_server>>();
 
@@ -3358,6 +3372,12 @@ void Emulator::Kill(bool allow_autoexit, bool savestate, savestate_stage* save_s
 
 			sys_log.notice("Atomic wait hashtable stats: [in_use=%u, used=%u, max_collision_weight=%u, total_collisions=%u]", aw_refs, aw_used, aw_colm, aw_colc);
 
+			if (const auto aw = atomic_wait::get_statistics(true); aw.waits)
+			{
+				sys_log.notice("Atomic wait engine stats: [size=%u, waits=%u, spurious=%u, slots=%u, collisions=%u, chained=%u, max_distance=%u]", aw.hashtable_size, aw.waits, aw.spurious_wakes, aw.slot_allocs, aw.slot_collisions, aw.slot_chained, aw.slot_max_distance);
+				sys_log.notice("Atomic wait engine stats: [notifies=%u, alerts=%u, max_fanout=%u, sema_slow_allocs=%u, sema_peak=%u/%u]", aw.notifies, aw.alerts, aw.alert_max_fanout, aw.cond_slow_allocs, aw.cond_peak, aw.cond_limit);
+			}
+
 			m_stop_ctr++;
 			m_stop_ctr.notify_all();
 
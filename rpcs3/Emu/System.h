@@ -327,7 +327,7 @@ public:
 	}
 
 	game_boot_result BootGame(const std::string& path, const std::string& title_id = "", bool direct = false, cfg_mode config_mode = cfg_mode::custom, const std::string& config_path = "");
-	bool BootRsxCapture(const std::string& path);
+	bool BootRsxCapture(const std::string& path, u32 benchmark_iterations = 0, const std::string& benchmark_report = "");
 
 	void SetForceBoot(bool force_boot);
 
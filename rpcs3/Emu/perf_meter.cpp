@@ -5,6 +5,7 @@
 #include "util/fence.hpp"
 #include "util/tsc.hpp"
 #include "Utilities/Thread.h"
+#include "Emu/CPU/CPUThread.h"
 
 #include <map>
 #include <mutex>
@@ -152,5 +153,7 @@ void perf_stat_base::report() noexcept
 
 	s_perf_acc.clear();
 
+	cpu_thread::report_suspend_stats();
+
 	perf_log.notice("Performance report end.");
 }
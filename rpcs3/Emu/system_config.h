@@ -24,6 +24,8 @@ struct cfg_root : cfg::node
 		cfg::_int<1, 8> ppu_threads{ this, "PPU Threads", 2 }; // Amount of PPU threads running simultaneously (must be 2)
 		cfg::_bool ppu_debug{ this, "PPU Debug" };
 		cfg::_bool ppu_call_history{ this, "PPU Calling History" }; // Enable PPU calling history recording
+		cfg::_bool ppu_hle_profiler{ this, "PPU HLE Function Profiler" }; // Count calls and time spent in HLE functions, reported on stop
+		cfg::_bool ppu_syscall_timing{ this, "PPU Syscall Latency Statistics" }; // Record time spent in syscalls, reported with the syscall usage
 		cfg::_bool llvm_logs{ this, "Save LLVM logs" };
 		cfg::string llvm_cpu{ this, "Use LLVM CPU" };
 		cfg::_int<0, 1024> llvm_threads{ this, "Max LLVM Compile Threads", 0 };
@@ -59,6 +61,7 @@ struct cfg_root : cfg::node
 		};
 
 		fifo_setting rsx_fifo_accuracy{this, "RSX FIFO Accuracy", rsx_fifo_mode::fast };
+		cfg::_bool rsx_fifo_predecode{ this, "RSX FIFO Pre-decode", false }; // Decode the command buffer ahead of the RSX thread on a separate thread (fast FIFO mode only)
 		cfg::_bool spu_verification{ this, "SPU Verification", true }; // Should be enabled
 		cfg::_bool spu_cache{ this, "SPU Cache", true };
 		cfg::_bool spu_prof{ this, "SPU Profiler", false };
@@ -101,6 +104,7 @@ struct cfg_root : cfg::node
 
 		cfg::uint64 perf_report_threshold{this, "Performance Report Threshold", 500, true}; // In µs, 0.5ms = default, 0 = everything
 		cfg::_bool perf_report{this, "Enable Performance Report", false, true}; // Show certain perf-related logs
+		cfg::uint64 suspend_all_budget{this, "Suspend All Latency Budget", 0, true}; // In µs, 0 = disabled. Log suspend_all() call sites which hold all threads for longer
 		cfg::_bool external_debugger{this, "Assume External Debugger"};
 	} core{ this };
 
@@ -160,10 +164,14 @@ struct cfg_root : cfg::node
 		cfg::_bool full_rgb_range_output{ this, "Use full RGB output range", true, true }; // Video out dynamic range
 		cfg::_bool strict_texture_flushing{ this, "Strict Texture Flushing", false };
 		cfg::_bool multithreaded_rsx{ this, "Multithreaded RSX", false };
+		cfg::_int<0, 8> offload_thread_count{ this, "Multithreaded RSX Worker Count", 0 }; // 0 = Auto
+		cfg::uint<0, 65536> offload_immediate_transfer_limit{ this, "Multithreaded RSX Immediate Transfer Limit", 0 }; // In bytes, 0 = calibrate on startup
 		cfg::_bool relaxed_zcull_sync{ this, "Relaxed ZCULL Sync", false };
 		cfg::_bool force_hw_MSAA_resolve{ this, "Force Hardware MSAA Resolve", false, true };
 		cfg::_enum<stereo_render_mode_options> stereo_render_mode{ this, "3D Display Mode", stereo_render_mode_options::disabled };
 		cfg::_bool debug_program_analyser{ this, "Debug Program Analyser", false };
+		cfg::_bool null_renderer_frontend_emulation{ this, "Null Renderer Front-End Emulation", false }; // Run the full RSX front end without a host GPU
+		cfg::_bool record_frame_timeline{ this, "Record Frame Timeline", false }; // Keep a per-thread event history that can be exported as a Chrome trace
 		cfg::_bool precise_zpass_count{ this, "Accurate ZCULL stats", true };
 		cfg::_int<1, 8> consecutive_frames_to_draw{ this, "Consecutive Frames To Draw", 1, true};
 		cfg::_int<1, 8> consecutive_frames_to_skip{ this, "Consecutive Frames To Skip", 1, true};
@@ -172,6 +180,7 @@ struct cfg_root : cfg::node
 		cfg::_float<-32, 32> texture_lod_bias{ this, "Texture LOD Bias Addend", 0, true };
 		cfg::_int<1, 1024> min_scalable_dimension{ this, "Minimum Scalable Dimension", 16 };
 		cfg::_int<0, 16> shader_compiler_threads_count{ this, "Shader Compiler Threads", 0 };
+		cfg::uint<0, 600> shader_cache_boot_window{ this, "Shader Cache Boot Window", 10 }; // Seconds, pipelines used later in the last session are compiled in the background. 0 = compile all before boot
 		cfg::_int<0, 30000000> driver_recovery_timeout{ this, "Driver Recovery Timeout", 1000000, true };
 		cfg::uint<0, 16667> driver_wakeup_delay{ this, "Driver Wake-Up Delay", 1, true };
 		cfg::_int<1, 3000> vblank_rate{ this, "Vblank Rate", 60, true }; // Changing this from 60 may affect game speed in unexpected ways
@@ -594,6 +594,7 @@ void fmt_class_string<thread_scheduler_mode>::format(std::string& out, u64 arg)
 		{
 		case thread_scheduler_mode::old: return "RPCS3 Scheduler";
 		case thread_scheduler_mode::alt: return "RPCS3 Alternative Scheduler";
+		case thread_scheduler_mode::topology: return "RPCS3 Topology Scheduler";
 		case thread_scheduler_mode::os: return "Operating System";
 		}
 
@@ -29,6 +29,7 @@
 #include "Utilities/sema.h"
 #include "Utilities/date_time.h"
 #include "Crypto/decrypt_binaries.h"
+#include "Emu/RSX/Program/pipeline_cache_file.h"
 #ifdef _WIN32
 #include "module_verifier.hpp"
 #include "util/dyn_lib.hpp"
@@ -299,6 +300,7 @@ struct fatal_error_listener final : logs::listener
 constexpr auto arg_headless     = "headless";
 constexpr auto arg_decrypt      = "decrypt";
 constexpr auto arg_commit_db    = "get-commit-db";
+constexpr auto arg_compact_pipe = "compact-pipeline-cache";
 
 // Arguments that can be used with a gui application
 constexpr auto arg_no_gui       = "no-gui";
@@ -319,6 +321,9 @@ constexpr auto arg_installfw    = "installfw";
 constexpr auto arg_installpkg   = "installpkg";
 constexpr auto arg_savestate    = "savestate";
 constexpr auto arg_rsx_capture  = "rsx-capture";
+constexpr auto arg_rsx_bench    = "rsx-capture-benchmark";
+constexpr auto arg_rsx_report   = "rsx-capture-report";
+constexpr auto arg_max_idle     = "max-idle-sessions";
 constexpr auto arg_timer        = "high-res-timer";
 constexpr auto arg_verbose_curl = "verbose-curl";
 constexpr auto arg_any_location = "allow-any-location";
@@ -337,7 +342,8 @@ QCoreApplication* create_application(int& argc, char* argv[])
 {
 	if (find_arg(arg_headless, argc, argv) != -1 ||
 		find_arg(arg_decrypt, argc, argv) != -1 ||
-		find_arg(arg_commit_db, argc, argv) != -1)
+		find_arg(arg_commit_db, argc, argv) != -1 ||
+		find_arg(arg_compact_pipe, argc, argv) != -1)
 	{
 		return new headless_application(argc, argv);
 	}
@@ -696,6 +702,14 @@ int main(int argc, char** argv)
 	parser.addOption(savestate_option);
 	const QCommandLineOption rsx_capture_option(arg_rsx_capture, "Path for directly loading an rsx capture.", "path", "");
 	parser.addOption(rsx_capture_option);
+	const QCommandLineOption rsx_bench_option(arg_rsx_bench, "Replay the rsx capture the given number of times and report per-frame CPU timings.", "iterations", "");
+	parser.addOption(rsx_bench_option);
+	const QCommandLineOption rsx_report_option(arg_rsx_report, "Path of the JSON report written by rsx-capture-benchmark.", "path", "");
+	parser.addOption(rsx_report_option);
+	const QCommandLineOption compact_pipe_option(arg_compact_pipe, "Prune idle entries from packed pipeline caches at or below this path.", "path", "");
+	parser.addOption(compact_pipe_option);
+	const QCommandLineOption max_idle_option(arg_max_idle, "Number of sessions an entry may go unused before compact-pipeline-cache prunes it.", "sessions", "10");
+	parser.addOption(max_idle_option);
 	parser.addOption(QCommandLineOption(arg_q_debug, "Log qDebug to RPCS3.log."));
 	parser.addOption(QCommandLineOption(arg_error, "For internal usage."));
 	parser.addOption(QCommandLineOption(arg_updating, "For internal usage."));
@@ -1199,6 +1213,51 @@ int main(int argc, char** argv)
 		return 0;
 	}
 
+	if (parser.isSet(arg_compact_pipe))
+	{
+#ifdef _WIN32
+		if (AttachConsole(ATTACH_PARENT_PROCESS) || AllocConsole())
+		{
+			[[maybe_unused]] const auto con_out = freopen("CONOUT$", "w", stdout);
+		}
+#endif
+
+		bool ok = false;
+		const u32 max_idle_sessions = parser.value(max_idle_option).toUInt(&ok);
+
+		if (!ok || !max_idle_sessions)
+		{
+			std::cout << "Invalid idle session count: " << parser.value(max_idle_option).toStdString() << std::endl;
+			return 1;
+		}
+
+		const std::vector<std::string> caches = rsx::pipeline_cache_file::find(parser.value(compact_pipe_option).toStdString());
+
+		if (caches.empty())
+		{
+			std::cout << "No pipeline caches found" << std::endl;
+			return 1;
+		}
+
+		int result = 0;
+
+		for (const std::string& path : caches)
+		{
+			u32 kept = 0, pruned = 0;
+
+			if (!rsx::pipeline_cache_file::compact(path, max_idle_sessions, kept, pruned))
+			{
+				std::cout << "Failed to compact " << path << ".pack" << std::endl;
+				result = 1;
+				continue;
+			}
+
+			std::cout << path << ".pack: kept " << kept << ", pruned " << pruned << std::endl;
+		}
+
+		return result;
+	}
+
 	// Force install firmware or pkg first if specified through command-line
 	if (parser.isSet(arg_installfw) || parser.isSet(arg_installpkg))
 	{
@@ -1275,9 +1334,22 @@ int main(int argc, char** argv)
 			report_fatal_error(fmt::format("No rsx capture file found: %s", rsx_capture_path));
 		}
 
-		Emu.CallFromMainThread([path = rsx_capture_path]()
+		u32 benchmark_iterations = 0;
+
+		if (parser.isSet(arg_rsx_bench))
+		{
+			bool ok = false;
+			benchmark_iterations = parser.value(rsx_bench_option).toUInt(&ok);
+
+			if (!ok || !benchmark_iterations)
+			{
+				report_fatal_error(fmt::format("Invalid rsx capture benchmark iteration count: %s", parser.value(rsx_bench_option).toStdString()));
+			}
+		}
+
+		Emu.CallFromMainThread([path = rsx_capture_path, benchmark_iterations, report = parser.value(rsx_report_option).toStdString()]()
 		{
-			if (!Emu.BootRsxCapture(path))
+			if (!Emu.BootRsxCapture(path, benchmark_iterations, report))
 			{
 				sys_log.error("Booting rsx capture '%s' failed", path);
 
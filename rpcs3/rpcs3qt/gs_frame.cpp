@@ -51,6 +51,7 @@ LOG_CHANNEL(gui_log, "GUI");
 extern atomic_t<bool> g_user_asked_for_recording;
 extern atomic_t<bool> g_user_asked_for_screenshot;
 extern atomic_t<bool> g_user_asked_for_frame_capture;
+extern atomic_t<bool> g_user_asked_for_timeline_dump;
 extern atomic_t<bool> g_disable_frame_limit;
 extern atomic_t<recording_mode> g_recording_mode;
 
@@ -276,6 +277,12 @@ void gs_frame::keyPressEvent(QKeyEvent *keyEvent)
 			handle_shortcut(gui::shortcuts::shortcut::gw_rsx_capture, {});
 		break;
 	}
+	case Qt::Key_T:
+	{
+		if (keyEvent->modifiers() == Qt::AltModifier)
+			handle_shortcut(gui::shortcuts::shortcut::gw_timeline_dump, {});
+		break;
+	}
 	case Qt::Key_F10:
 	{
 		if (keyEvent->modifiers() == Qt::ControlModifier)
@@ -404,6 +411,14 @@ void gs_frame::handle_shortcut(gui::shortcuts::shortcut shortcut_key, const QKey
 		}
 		break;
 	}
+	case gui::shortcuts::shortcut::gw_timeline_dump:
+	{
+		if (!m_disable_kb_hotkeys)
+		{
+			g_user_asked_for_timeline_dump = true;
+		}
+		break;
+	}
 	case gui::shortcuts::shortcut::gw_frame_limit:
 	{
 		g_disable_frame_limit = !g_disable_frame_limit;
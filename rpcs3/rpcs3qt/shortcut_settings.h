@@ -35,6 +35,7 @@ namespace gui
 			gw_savestate,
 			gw_restart,
 			gw_rsx_capture,
+			gw_timeline_dump,
 			gw_frame_limit,
 
 			count
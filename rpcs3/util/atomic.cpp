@@ -52,8 +52,14 @@ static bool has_waitv()
 #include "endian.hpp"
 #include "tsc.hpp"
 
-// Total number of entries.
-static constexpr usz s_hashtable_size = 1u << 17;
+#ifndef ATOMIC_WAIT_HASHTABLE_BITS
+#define ATOMIC_WAIT_HASHTABLE_BITS 17
+#endif
+
+// Total number of entries (two halves, each is addressed by 16-bit subpointers)
+static constexpr usz s_hashtable_size = usz{1} << ATOMIC_WAIT_HASHTABLE_BITS;
+
+static_assert(ATOMIC_WAIT_HASHTABLE_BITS >= 10 && ATOMIC_WAIT_HASHTABLE_BITS <= 17, "ATOMIC_WAIT_HASHTABLE_BITS must be in range [10, 17]");
 
 // Reference counter combined with shifted pointer (which is assumed to be 48 bit)
 static constexpr uptr s_ref_mask = 0xffff;
@@ -95,6 +101,53 @@ static NEVER_INLINE bool ptr_cmp(const void* data, u32 old, atomic_wait::info* e
 
 static atomic_t<u64> s_min_tsc{0};
 
+#ifdef ATOMIC_WAIT_STATS
+static constexpr bool s_stats_enabled = true;
+#else
+static constexpr bool s_stats_enabled = false;
+#endif
+
+// Contention counters, compiled out unless ATOMIC_WAIT_STATS is defined (global counters add contention of their own)
+static struct alignas(64) atomic_wait_stats_t
+{
+	atomic_t<u64> slot_allocs;
+	atomic_t<u64> slot_collisions;
+	atomic_t<u64> slot_chained;
+	atomic_t<u64> slot_max_distance;
+	atomic_t<u64> waits;
+	atomic_t<u64> spurious_wakes;
+	atomic_t<u64> notifies;
+	atomic_t<u64> alerts;
+	atomic_t<u64> alert_max_fanout;
+	atomic_t<u64> cond_slow_allocs;
+	atomic_t<u64> cond_peak;
+} s_stats{};
+
+static FORCE_INLINE void stats_add(atomic_t<u64>& var, u64 value = 1)
+{
+	if constexpr (s_stats_enabled)
+	{
+		var += value;
+	}
+}
+
+static FORCE_INLINE void stats_update_max(atomic_t<u64>& var, u64 value)
+{
+	if (s_stats_enabled && var.load() < value)
+	{
+		var.fetch_op([&](u64& val)
+		{
+			if (val < value)
+			{
+				val = value;
+				return true;
+			}
+
+			return false;
+		});
+	}
+}
+
 namespace
 {
 #ifdef USE_STD
@@ -393,7 +446,9 @@ static u32 cond_alloc(uptr iptr, u32 tls_slot = -1)
 		return id;
 	}
 
-	const u32 level1 = s_cond_sem1.atomic_op([](u128& val) -> u32
+	u32 in_use = 0;
+
+	const u32 level1 = s_cond_sem1.atomic_op([&](u128& val) -> u32
 	{
 		constexpr u128 max_mask = dup8(8192);
 
@@ -408,9 +463,23 @@ static u32 cond_alloc(uptr iptr, u32 tls_slot = -1)
 
 		val += u128{1} << (pos / 14 * 14);
 
+		if constexpr (s_stats_enabled)
+		{
+			// Sum of the sub-semaphore counters (the first one includes reserved id 0)
+			in_use = 0;
+
+			for (u32 i = 0; i < 8; i++)
+			{
+				in_use += static_cast<u32>(val >> (i * 14)) & 0x3fff;
+			}
+		}
+
 		return pos / 14;
 	});
 
+	stats_add(s_stats.cond_slow_allocs);
+	stats_update_max(s_stats.cond_peak, in_use - 1);
+
 	// Determine whether there is a free slot or not
 	if (level1 < 8) [[likely]]
 	{
@@ -639,25 +708,27 @@ namespace
 		// Pointer to the current hashtable slot
 		u32 id;
 
+		static constexpr u32 half = s_hashtable_size / 2;
+
 		// Initialize: PRNG on iptr, split into two 16 bit chunks, choose first chunk
 		explicit hash_engine(uptr iptr)
 			: init(rng(iptr)())
 			, r0(static_cast<u16>(init >> 48))
 			, r1(static_cast<u16>(init >> 32))
-			, id(static_cast<u32>(init) >> 31 ? r0 : r1 + 0x10000)
+			, id(static_cast<u32>(init) >> 31 ? r0 % half : r1 % half + half)
 		{
 		}
 
-		// Advance: linearly to prevent self-collisions, but always switch between two big 2^16 chunks
+		// Advance: linearly to prevent self-collisions, but always switch between two halves of the table
 		void advance() noexcept
 		{
-			if (id >= 0x10000)
+			if (id >= half)
 			{
-				id = r0++;
+				id = r0++ % half;
 			}
 			else
 			{
-				id = r1++ + 0x10000;
+				id = r1++ % half + half;
 			}
 		}
 
@@ -698,10 +769,18 @@ atomic_t<u16>* root_info::slot_alloc(uptr ptr) noexcept
 
 	u32 limit = 0;
 
+	bool collided = false;
+
 	for (hash_engine _this(ptr);; _this.advance())
 	{
 		slot = _this->bits.atomic_op([&](slot_allocator& bits) -> atomic_t<u16>*
 		{
+			if (!limit)
+			{
+				// Waiters on other addresses already present in the home slot
+				collided = bits.ref && bits.iptr != ptr;
+			}
+
 			// Increment reference counter on every hashtable slot we attempt to allocate on
 			if (bits.ref == u16{umax})
 			{
@@ -730,6 +809,19 @@ atomic_t<u16>* root_info::slot_alloc(uptr ptr) noexcept
 
 		if (slot)
 		{
+			stats_add(s_stats.slot_allocs);
+
+			if (collided)
+			{
+				stats_add(s_stats.slot_collisions);
+			}
+
+			if (limit)
+			{
+				stats_add(s_stats.slot_chained);
+				stats_update_max(s_stats.slot_max_distance, limit);
+			}
+
 			break;
 		}
 
@@ -1021,8 +1113,16 @@ atomic_wait_engine::wait(const void* data, u32 old_value, u64 timeout, atomic_wa
 
 	u64 attempts = 0;
 
+	stats_add(s_stats.waits);
+
 	while (ptr_cmp(data, old_value, ext))
 	{
+		if (attempts)
+		{
+			// Woken up (or timed out) while the value is unchanged
+			stats_add(s_stats.spurious_wakes);
+		}
+
 		if (s_tls_one_time_wait_cb)
 		{
 			if (!s_tls_one_time_wait_cb(attempts))
@@ -1272,6 +1372,9 @@ void atomic_wait_engine::notify_one(const void* data)
 	{
 		if (alert_sema(cond_id, 4))
 		{
+			stats_add(s_stats.notifies);
+			stats_add(s_stats.alerts);
+			stats_update_max(s_stats.alert_max_fanout, 1);
 			return true;
 		}
 
@@ -1302,6 +1405,9 @@ atomic_wait_engine::notify_all(const void* data)
 	// Array count for batch notification
 	u32 count = 0;
 
+	// Semaphores alerted through notify_one fallback
+	u32 count_extra = 0;
+
 	// Array itself.
 	u32 cond_ids[128];
 
@@ -1310,7 +1416,7 @@ atomic_wait_engine::notify_all(const void* data)
 		if (count >= 128)
 		{
 			// Unusual big amount of sema: fallback to notify_one alg
-			alert_sema(cond_id, 4);
+			count_extra += alert_sema(cond_id, 4) != 0;
 			return false;
 		}
 
@@ -1370,6 +1476,13 @@ atomic_wait_engine::notify_all(const void* data)
 		cond_free(~*(std::end(cond_ids) - i - 1));
 	}
 
+	if (const u32 fanout = count + count_extra)
+	{
+		stats_add(s_stats.notifies);
+		stats_add(s_stats.alerts, fanout);
+		stats_update_max(s_stats.alert_max_fanout, fanout);
+	}
+
 	if (s_tls_notify_cb)
 		s_tls_notify_cb(data, -1);
 }
@@ -1389,4 +1502,28 @@ namespace atomic_wait
 			}
 		}
 	}
+
+	statistics get_statistics(bool reset)
+	{
+		const auto take = [&](atomic_t<u64>& var)
+		{
+			return reset ? var.exchange(0) : var.load();
+		};
+
+		statistics r{};
+		r.hashtable_size = s_hashtable_size;
+		r.slot_allocs = take(s_stats.slot_allocs);
+		r.slot_collisions = take(s_stats.slot_collisions);
+		r.slot_chained = take(s_stats.slot_chained);
+		r.slot_max_distance = take(s_stats.slot_max_distance);
+		r.waits = take(s_stats.waits);
+		r.spurious_wakes = take(s_stats.spurious_wakes);
+		r.notifies = take(s_stats.notifies);
+		r.alerts = take(s_stats.alerts);
+		r.alert_max_fanout = take(s_stats.alert_max_fanout);
+		r.cond_slow_allocs = take(s_stats.cond_slow_allocs);
+		r.cond_peak = take(s_stats.cond_peak);
+		r.cond_limit = u16{umax};
+		return r;
+	}
 }
@@ -232,6 +232,26 @@ namespace atomic_wait
 
 	template <typename... T, typename = std::void_t<decltype(std::declval<T>().wait(any_value))...>>
 	list(T&... vars) -> list<sizeof...(T), T...>;
+
+	// Counters of the fallback wait engine, only collected in builds with ATOMIC_WAIT_STATS (the hashtable is bypassed when futex_waitv is available)
+	struct statistics
+	{
+		u64 hashtable_size;
+		u64 slot_allocs;       // Hashtable slots allocated by waiters
+		u64 slot_collisions;   // Waiters sharing the home slot with waiters on another address
+		u64 slot_chained;      // Waiters which had to probe beyond the home slot
+		u64 slot_max_distance; // Longest probe sequence
+		u64 waits;             // Waits which reached the hashtable
+		u64 spurious_wakes;    // Wakeups which found the value unchanged
+		u64 notifies;          // Notifications which alerted at least one waiter
+		u64 alerts;            // Total waiters alerted
+		u64 alert_max_fanout;  // Most waiters alerted by a single notification
+		u64 cond_slow_allocs;  // Semaphores allocated without the TLS cache
+		u64 cond_peak;         // Most semaphores allocated at once
+		u64 cond_limit;
+	};
+
+	statistics get_statistics(bool reset = false);
 }
 
 namespace utils
@@ -1,5 +1,6 @@
 #include "util/sysinfo.hpp"
 #include "Utilities/StrFmt.h"
+#include "Utilities/StrUtil.h"
 #include "Utilities/File.h"
 #include "Emu/vfs_config.h"
 #include "Utilities/Thread.h"
@@ -21,6 +22,9 @@
 #include "util/asm.hpp"
 #include "util/fence.hpp"
 
+#include <algorithm>
+#include <bit>
+
 #if defined(_M_X64) && defined(_MSC_VER)
 extern "C" u64 _xgetbv(u32);
 #endif
@@ -752,6 +756,186 @@ u32 utils::get_thread_count()
 	return g_count;
 }
 
+#if !defined(_WIN32) && !defined(__APPLE__)
+// Parses sysfs CPU lists such as "0-3,8-11", CPUs beyond the first 64 are ignored
+static u64 read_cpu_list(const std::string& path)
+{
+	const fs::file file(path);
+
+	if (!file)
+	{
+		return 0;
+	}
+
+	u64 result = 0;
+
+	for (const std::string& range : fmt::split(file.to_string(), {",", "\n"}))
+	{
+		const usz sep = range.find('-');
+		const u32 first = static_cast<u32>(std::strtoul(range.c_str(), nullptr, 10));
+		const u32 last = sep == umax ? first : static_cast<u32>(std::strtoul(range.c_str() + sep + 1, nullptr, 10));
+
+		for (u32 i = first; i <= last && i < 64; i++)
+		{
+			result |= u64{1} << i;
+		}
+	}
+
+	return result;
+}
+#endif
+
+const std::vector<utils::cpu_core_info>& utils::get_cpu_topology()
+{
+	static const std::vector<cpu_core_info> g_cores = []()
+	{
+		std::vector<cpu_core_info> cores;
+		std::vector<u64> cache_masks;
+
+		const auto find_cache_domain = [&](u64 mask) -> u32
+		{
+			for (u32 i = 0; i < cache_masks.size(); i++)
+			{
+				if (cache_masks[i] & mask)
+				{
+					return i;
+				}
+			}
+
+			cache_masks.push_back(mask);
+			return ::size32(cache_masks) - 1;
+		};
+
+#ifdef _WIN32
+		DWORD buffer_size = 0;
+		GetLogicalProcessorInformationEx(RelationAll, nullptr, &buffer_size);
+
+		std::vector<u8> buffer(buffer_size);
+
+		if (buffer_size && GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data()), &buffer_size))
+		{
+			std::vector<std::pair<u64, u32>> numa_nodes;
+
+			for (uptr ptr = reinterpret_cast<uptr>(buffer.data()), end = ptr + buffer_size; ptr < end;)
+			{
+				const auto info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(ptr);
+				ptr += info->Size;
+
+				// Only the first processor group is addressable by the affinity masks
+				switch (info->Relationship)
+				{
+				case RelationProcessorCore:
+					if (info->Processor.GroupMask[0].Group == 0 && info->Processor.GroupMask[0].Mask)
+						cores.push_back({info->Processor.GroupMask[0].Mask, 0, 0, info->Processor.EfficiencyClass});
+					break;
+				case RelationCache:
+					if (info->Cache.Level == 3 && info->Cache.GroupMask.Group == 0)
+						find_cache_domain(info->Cache.GroupMask.Mask);
+					break;
+				case RelationNumaNode:
+					if (info->NumaNode.GroupMask.Group == 0)
+						numa_nodes.emplace_back(info->NumaNode.GroupMask.Mask, info->NumaNode.NodeNumber);
+					break;
+				default:
+					break;
+				}
+			}
+
+			for (auto& core : cores)
+			{
+				for (const auto& [mask, node] : numa_nodes)
+				{
+					if (mask & core.threads)
+						core.numa_node = node;
+				}
+			}
+		}
+#elif !defined(__APPLE__)
+		std::vector<u64> numa_masks;
+
+		for (u32 node = 0; node < 64; node++)
+		{
+			const u64 mask = read_cpu_list(fmt::format("/sys/devices/system/node/node%u/cpulist", node));
+
+			if (!mask && node)
+			{
+				break;
+			}
+
+			numa_masks.push_back(mask);
+		}
+
+		// Hybrid Intel CPUs expose the efficiency cores as a separate PMU
+		const u64 atom_mask = read_cpu_list("/sys/devices/cpu_atom/cpus");
+		u64 known_mask = 0;
+
+		for (u32 cpu = 0; cpu < std::min<u32>(get_thread_count(), 64); cpu++)
+		{
+			const std::string base = fmt::format("/sys/devices/system/cpu/cpu%u/", cpu);
+			const u64 siblings = read_cpu_list(base + "topology/thread_siblings_list");
+
+			if (!siblings || known_mask & (u64{1} << cpu))
+			{
+				continue;
+			}
+
+			known_mask |= siblings;
+
+			cpu_core_info core{siblings, 0, 0, 1};
+
+			if (const u64 llc = read_cpu_list(base + "cache/index3/shared_cpu_list"))
+			{
+				find_cache_domain(llc);
+			}
+
+			for (u32 node = 0; node < numa_masks.size(); node++)
+			{
+				if (numa_masks[node] & siblings)
+					core.numa_node = node;
+			}
+
+			if (atom_mask)
+			{
+				core.efficiency = (atom_mask & siblings) ? 0 : 1;
+			}
+			else if (const fs::file capacity{base + "cpu_capacity"})
+			{
+				// Asymmetric ARM systems report a normalized capacity (up to 1024)
+				core.efficiency = static_cast<u32>(std::strtoul(capacity.to_string().c_str(), nullptr, 10));
+			}
+
+			cores.push_back(core);
+		}
+#endif
+
+		if (cores.empty())
+		{
+			// Unknown layout, treat every logical processor as a separate core
+			for (u32 cpu = 0; cpu < std::min<u32>(get_thread_count(), 64); cpu++)
+			{
+				cores.push_back({u64{1} << cpu, 0, 0, 0});
+			}
+		}
+
+		for (auto& core : cores)
+		{
+			if (!cache_masks.empty())
+			{
+				core.cache_domain = find_cache_domain(core.threads);
+			}
+		}
+
+		std::sort(cores.begin(), cores.end(), [](const cpu_core_info& a, const cpu_core_info& b)
+		{
+			return std::countr_zero(a.threads) < std::countr_zero(b.threads);
+		});
+
+		return cores;
+	}();
+
+	return g_cores;
+}
+
 u32 utils::get_cpu_family()
 {
 #if defined(ARCH_X64)
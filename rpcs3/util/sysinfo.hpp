@@ -2,6 +2,7 @@
 
 #include "util/types.hpp"
 #include <string>
+#include <vector>
 
 namespace utils
 {
@@ -83,6 +84,17 @@ namespace utils
 
 	u32 get_cpu_model();
 
+	struct cpu_core_info
+	{
+		u64 threads;      // Logical processors of the core (SMT siblings)
+		u32 cache_domain; // Cores with the same value share the last level cache
+		u32 numa_node;
+		u32 efficiency;   // Relative performance class, higher is faster (equal on non-hybrid CPUs)
+	};
+
+	// Physical cores backing the first 64 logical processors, ordered by their first logical processor
+	const std::vector<cpu_core_info>& get_cpu_topology();
+
 	// A threshold of 0xFFFFFFFF means that the rep movsb is expected to be slow on this platform
 	u32 get_rep_movsb_threshold();
 